@@ -8,7 +8,9 @@
 #include "devices/timer.h"
 #include "threads/io.h"
 #include "threads/interrupt.h"
+#include "threads/stats.h"
 #include "threads/synch.h"
+#include "threads/trace.h"
 
 /* The code in this file is an interface to an ATA (IDE)
    controller.  It attempts to comply to [ATA-3]. */
@@ -68,6 +70,7 @@ struct channel
     uint8_t irq;                /* Interrupt in use. */
 
     struct lock lock;           /* Must acquire to access the controller. */
+    struct lock_stats lock_stats;   /* Contention on `lock'. */
     bool expecting_interrupt;   /* True if an interrupt is expected, false if
                                    any interrupt would be spurious. */
     struct semaphore completion_wait;   /* Up'd by interrupt handler. */
@@ -81,6 +84,12 @@ static struct channel channels[CHANNEL_CNT];
 
 static struct block_operations ide_operations;
 
+/* Disk statistics. */
+static struct stat_counter sectors_read;    /* Sectors read. */
+static struct stat_counter sectors_written; /* Sectors written. */
+static struct stat_hist queue_wait;         /* Cycles spent waiting for
+                                               a channel. */
+
 static void reset_channel (struct channel *);
 static bool check_device_type (struct ata_disk *);
 static void identify_ata_device (struct ata_disk *);
@@ -103,6 +112,10 @@ ide_init (void)
 {
   size_t chan_no;
 
+  stats_register_counter (&sectors_read, "ide.sectors_read");
+  stats_register_counter (&sectors_written, "ide.sectors_written");
+  stats_register_hist (&queue_wait, "ide.queue_wait");
+
   for (chan_no = 0; chan_no < CHANNEL_CNT; chan_no++)
     {
       struct channel *c = &channels[chan_no];
@@ -124,6 +137,7 @@ ide_init (void)
           NOT_REACHED ();
         }
       lock_init (&c->lock);
+      lock_profile (&c->lock, &c->lock_stats, c->name);
       c->expecting_interrupt = false;
       sema_init (&c->completion_wait, 0);
  
@@ -337,6 +351,24 @@ descramble_ata_string (char *string, int size)
   return string;
 }
 
+/* Acquires channel C for a transfer, recording how long we had
+   to wait for other transfers queued ahead of us. */
+static void
+acquire_channel (struct channel *c)
+{
+  uint64_t start = stats_clock ();
+  lock_acquire (&c->lock);
+  stat_hist_add (&queue_wait, stats_clock () - start);
+}
+
+/* Returns D's number in trace events: 2 * its channel number
+   plus its device number. */
+static uint32_t
+disk_no (const struct ata_disk *d)
+{
+  return (d->channel - channels) * 2 + d->dev_no;
+}
+
 /* Reads sector SEC_NO from disk D into BUFFER, which must have
    room for BLOCK_SECTOR_SIZE bytes.
    Internally synchronizes accesses to disks, so external
@@ -346,10 +378,13 @@ ide_read (void *d_, block_sector_t sec_no, void *buffer)
 {
   struct ata_disk *d = d_;
   struct channel *c = d->channel;
-  lock_acquire (&c->lock);
+  acquire_channel (c);
+  stat_inc (&sectors_read);
+  trace (TRACE_DISK_ISSUE, sec_no, disk_no (d));
   select_sector (d, sec_no);
   issue_pio_command (c, CMD_READ_SECTOR_RETRY);
   sema_down (&c->completion_wait);
+  trace (TRACE_DISK_COMPLETE, sec_no, disk_no (d));
   if (!wait_while_busy (d))
     PANIC ("%s: disk read failed, sector=%"PRDSNu, d->name, sec_no);
   input_sector (c, buffer);
@@ -366,13 +401,16 @@ ide_write (void *d_, block_sector_t sec_no, const void *buffer)
 {
   struct ata_disk *d = d_;
   struct channel *c = d->channel;
-  lock_acquire (&c->lock);
+  acquire_channel (c);
+  stat_inc (&sectors_written);
+  trace (TRACE_DISK_ISSUE, sec_no, disk_no (d) | 0x100);
   select_sector (d, sec_no);
   issue_pio_command (c, CMD_WRITE_SECTOR_RETRY);
   if (!wait_while_busy (d))
     PANIC ("%s: disk write failed, sector=%"PRDSNu, d->name, sec_no);
   output_sector (c, buffer);
   sema_down (&c->completion_wait);
+  trace (TRACE_DISK_COMPLETE, sec_no, disk_no (d) | 0x100);
   lock_release (&c->lock);
 }
 
@@ -5,12 +5,13 @@
 
 /* Stores keys from the keyboard and serial port. */
 static struct intq buffer;
+static uint8_t buffer_space[INPUT_BUFSIZE];
 
 /* Initializes the input buffer. */
 void
 input_init (void) 
 {
-  intq_init (&buffer);
+  intq_init_buffer (&buffer, buffer_space, sizeof buffer_space);
 }
 
 /* Adds a key to the input buffer.
@@ -41,6 +42,25 @@ input_getc (void)
   return key;
 }
 
+/* Retrieves up to SIZE keys from the input buffer into BUFFER
+   and returns the number retrieved.  If the buffer is empty and
+   WAIT is true, first waits for a key to be pressed; otherwise,
+   retrieves only the keys already in the buffer, which may be
+   none.  Much cheaper than calling input_getc() for each key. */
+size_t
+input_read (void *buffer_, size_t size, bool wait) 
+{
+  enum intr_level old_level;
+  size_t cnt;
+
+  old_level = intr_disable ();
+  cnt = intq_read (&buffer, buffer_, size, wait);
+  serial_notify ();
+  intr_set_level (old_level);
+
+  return cnt;
+}
+
 /* Returns true if the input buffer is full,
    false otherwise.
    Interrupts must be off. */
@@ -2,11 +2,22 @@
 #define DEVICES_INPUT_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+/* Size of the input buffer, in bytes.  Bytes that arrive on the
+   serial port while the buffer is full are held back by the
+   UART, so a larger buffer lets more piped-in input be taken in
+   while no one is reading.  May be overridden at compile time,
+   e.g. with -DINPUT_BUFSIZE=65536 in CFLAGS. */
+#ifndef INPUT_BUFSIZE
+#define INPUT_BUFSIZE 4096
+#endif
+
 void input_init (void);
 void input_putc (uint8_t);
 uint8_t input_getc (void);
+size_t input_read (void *, size_t, bool wait);
 bool input_full (void);
 
 #endif /* devices/input.h */
@@ -1,17 +1,32 @@
 #include "devices/intq.h"
 #include <debug.h>
+#include <string.h>
 #include "threads/thread.h"
 
-static int next (int pos);
+static size_t next (const struct intq *q, size_t pos);
 static void wait (struct intq *q, struct thread **waiter);
 static void signal (struct intq *q, struct thread **waiter);
 
-/* Initializes interrupt queue Q. */
+/* Initializes interrupt queue Q with a buffer of INTQ_BUFSIZE
+   bytes. */
 void
 intq_init (struct intq *q) 
 {
+  intq_init_buffer (q, q->default_buf, sizeof q->default_buf);
+}
+
+/* Initializes interrupt queue Q to use the SIZE bytes in BUF as
+   its buffer.  Q can hold up to SIZE - 1 bytes at a time. */
+void
+intq_init_buffer (struct intq *q, uint8_t *buf, size_t size) 
+{
+  ASSERT (buf != NULL);
+  ASSERT (size >= 2);
+
   lock_init (&q->lock);
   q->not_full = q->not_empty = NULL;
+  q->buf = buf;
+  q->size = size;
   q->head = q->tail = 0;
 }
 
@@ -28,7 +43,7 @@ bool
 intq_full (const struct intq *q) 
 {
   ASSERT (intr_get_level () == INTR_OFF);
-  return next (q->head) == q->tail;
+  return next (q, q->head) == q->tail;
 }
 
 /* Removes a byte from Q and returns it.
@@ -49,7 +64,7 @@ intq_getc (struct intq *q)
     }
   
   byte = q->buf[q->tail];
-  q->tail = next (q->tail);
+  q->tail = next (q, q->tail);
   signal (q, &q->not_full);
   return byte;
 }
@@ -70,15 +85,55 @@ intq_putc (struct intq *q, uint8_t byte)
     }
 
   q->buf[q->head] = byte;
-  q->head = next (q->head);
+  q->head = next (q, q->head);
   signal (q, &q->not_empty);
 }
+
+/* Removes up to SIZE bytes from Q and copies them into BUFFER,
+   returning the number of bytes copied.  If Q is empty and WAIT
+   is true, first sleeps until a byte is added; otherwise, copies
+   only the bytes that are already in Q, which may be none.
+   This is equivalent to calling intq_getc() once per byte, but
+   copies the bytes in at most two contiguous runs. */
+size_t
+intq_read (struct intq *q, void *buffer_, size_t size, bool wait_) 
+{
+  uint8_t *buffer = buffer_;
+  size_t copied = 0;
+
+  ASSERT (intr_get_level () == INTR_OFF);
+  if (size == 0)
+    return 0;
+  while (wait_ && intq_empty (q)) 
+    {
+      ASSERT (!intr_context ());
+      lock_acquire (&q->lock);
+      wait (q, &q->not_empty);
+      lock_release (&q->lock);
+    }
+
+  while (copied < size && !intq_empty (q))
+    {
+      size_t end = q->head >= q->tail ? q->head : q->size;
+      size_t chunk = end - q->tail;
+
+      if (chunk > size - copied)
+        chunk = size - copied;
+      memcpy (buffer + copied, q->buf + q->tail, chunk);
+      copied += chunk;
+      q->tail = (q->tail + chunk) % q->size;
+    }
+
+  if (copied > 0)
+    signal (q, &q->not_full);
+  return copied;
+}
 
-/* Returns the position after POS within an intq. */
-static int
-next (int pos) 
+/* Returns the position after POS within Q. */
+static size_t
+next (const struct intq *q, size_t pos) 
 {
-  return (pos + 1) % INTQ_BUFSIZE;
+  return (pos + 1) % q->size;
 }
 
 /* WAITER must be the address of Q's not_empty or not_full
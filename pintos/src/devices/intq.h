@@ -1,6 +1,9 @@
 #ifndef DEVICES_INTQ_H
 #define DEVICES_INTQ_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "threads/interrupt.h"
 #include "threads/synch.h"
 
@@ -17,7 +20,8 @@
    protect kernel threads from one another, not from interrupt
    handlers. */
 
-/* Queue buffer size, in bytes. */
+/* Default queue buffer size, in bytes.  Use intq_init_buffer()
+   for a queue with a different size. */
 #define INTQ_BUFSIZE 64
 
 /* A circular queue of bytes. */
@@ -29,15 +33,19 @@ struct intq
     struct thread *not_empty;   /* Thread waiting for not-empty condition. */
 
     /* Queue. */
-    uint8_t buf[INTQ_BUFSIZE];  /* Buffer. */
-    int head;                   /* New data is written here. */
-    int tail;                   /* Old data is read here. */
+    uint8_t *buf;               /* Buffer. */
+    size_t size;                /* Size of buf in bytes. */
+    size_t head;                /* New data is written here. */
+    size_t tail;                /* Old data is read here. */
+    uint8_t default_buf[INTQ_BUFSIZE]; /* Buffer used by intq_init(). */
   };
 
 void intq_init (struct intq *);
+void intq_init_buffer (struct intq *, uint8_t *buf, size_t size);
 bool intq_empty (const struct intq *);
 bool intq_full (const struct intq *);
 uint8_t intq_getc (struct intq *);
 void intq_putc (struct intq *, uint8_t);
+size_t intq_read (struct intq *, void *, size_t, bool wait);
 
 #endif /* devices/intq.h */
@@ -33,6 +33,13 @@
 #define MCR_REG (IO_BASE + 4)   /* MODEM Control Register. */
 #define LSR_REG (IO_BASE + 5)   /* Line Status Register (read-only). */
 
+/* FIFO Control Register bits. */
+#define FCR_ENABLE 0x01         /* Enable FIFOs. */
+#define FCR_CLEAR 0x06          /* Clear receive and transmit FIFOs. */
+
+/* Interrupt Identification Register bits. */
+#define IIR_FIFO 0xc0           /* FIFOs enabled and working. */
+
 /* Interrupt Enable Register bits. */
 #define IER_RECV 0x01           /* Interrupt when data received. */
 #define IER_XMIT 0x02           /* Interrupt when transmit finishes. */
@@ -54,6 +61,12 @@ static enum { UNINIT, POLL, QUEUE } mode;
 /* Data to be transmitted. */
 static struct intq txq;
 
+/* Number of bytes we may write to the UART at once when it
+   reports that it is ready to transmit: the depth of its
+   transmit FIFO, or 1 if it has none. */
+#define UART_FIFO_SIZE 16
+static size_t xmit_burst = 1;
+
 static void set_serial (int bps);
 static void putc_poll (uint8_t);
 static void write_ier (void);
@@ -88,6 +101,16 @@ serial_init_queue (void)
   ASSERT (mode == POLL);
 
   intr_register_ext (0x20 + 4, serial_interrupt, "serial");
+
+  /* Turn on the FIFOs, if the UART has working ones, so that
+     each transmit interrupt can send a burst of bytes instead
+     of just one. */
+  outb (FCR_REG, FCR_ENABLE | FCR_CLEAR);
+  if ((inb (IIR_REG) & IIR_FIFO) == IIR_FIFO)
+    xmit_burst = UART_FIFO_SIZE;
+  else
+    outb (FCR_REG, 0);
+
   mode = QUEUE;
   old_level = intr_disable ();
   write_ier ();
@@ -129,6 +152,45 @@ serial_putc (uint8_t byte)
   intr_set_level (old_level);
 }
 
+/* Sends the N bytes in BUFFER to the serial port.  The same as
+   calling serial_putc() for each byte, but interrupts are
+   disabled only once for the whole buffer, except while waiting
+   for the transmit queue to drain. */
+void
+serial_putbuf (const void *buffer_, size_t n) 
+{
+  const uint8_t *buffer = buffer_;
+  enum intr_level old_level = intr_disable ();
+
+  if (mode != QUEUE)
+    {
+      if (mode == UNINIT)
+        init_poll ();
+      while (n-- > 0)
+        putc_poll (*buffer++);
+    }
+  else
+    {
+      while (n-- > 0)
+        {
+          if (intq_full (&txq)) 
+            {
+              /* Make sure the transmit interrupt is on before
+                 intq_putc() waits for it to make room.  With
+                 interrupts off, poll as serial_putc() does. */
+              if (old_level == INTR_OFF)
+                putc_poll (intq_getc (&txq));
+              else
+                write_ier ();
+            }
+          intq_putc (&txq, *buffer++);
+        }
+      write_ier ();
+    }
+
+  intr_set_level (old_level);
+}
+
 /* Flushes anything in the serial buffer out the port in polling
    mode. */
 void
@@ -218,10 +280,17 @@ serial_interrupt (struct intr_frame *f UNUSED)
   while (!input_full () && (inb (LSR_REG) & LSR_DR) != 0)
     input_putc (inb (RBR_REG));
 
-  /* As long as we have a byte to transmit, and the hardware is
-     ready to accept a byte for transmission, transmit a byte. */
-  while (!intq_empty (&txq) && (inb (LSR_REG) & LSR_THRE) != 0) 
-    outb (THR_REG, intq_getc (&txq));
+  /* If we have bytes to transmit and the transmitter is empty,
+     refill it with as many bytes as it holds in a single burst. */
+  if (!intq_empty (&txq) && (inb (LSR_REG) & LSR_THRE) != 0) 
+    {
+      uint8_t burst[UART_FIFO_SIZE];
+      size_t n = 0;
+
+      while (n < xmit_burst && !intq_empty (&txq))
+        burst[n++] = intq_getc (&txq);
+      outsb (THR_REG, burst, n);
+    }
 
   /* Update interrupt enable register based on queue status. */
   write_ier ();
@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include "devices/pit.h"
 #include "threads/interrupt.h"
+#include "threads/profile.h"
 #include "threads/synch.h"
 #include "threads/thread.h"
   
@@ -23,6 +24,16 @@ static struct list sleeping_list;
 /* Number of timer ticks since OS booted. */
 static int64_t ticks;
 
+/* Lets timer_ticks() read `ticks' without disabling interrupts.
+   Only timer_interrupt() writes it. */
+static struct seqlock ticks_seqlock = SEQLOCK_INITIALIZER;
+
+/* Number of timer interrupts per timer tick, normally 1 but more
+   while the sampling profiler runs faster than TIMER_FREQ, and
+   interrupts left until the next tick. */
+static unsigned intrs_per_tick = 1;
+static unsigned intrs_left = 1;
+
 /* Number of loops per timer tick.
    Initialized by timer_calibrate(). */
 static unsigned loops_per_tick;
@@ -44,6 +55,25 @@ timer_init (void)
   list_init(&sleeping_list);
 }
 
+/* Reprograms the timer to interrupt about FREQ times per second,
+   which must be at least TIMER_FREQ, and returns the actual
+   rate.  The rate is rounded down to a multiple of TIMER_FREQ so
+   that ticks keep advancing TIMER_FREQ times per second. */
+unsigned
+timer_set_interrupt_freq (unsigned freq)
+{
+  enum intr_level old_level;
+
+  ASSERT (freq >= TIMER_FREQ);
+
+  old_level = intr_disable ();
+  intrs_per_tick = intrs_left = freq / TIMER_FREQ;
+  pit_configure_channel (0, 2, intrs_per_tick * TIMER_FREQ);
+  intr_set_level (old_level);
+
+  return intrs_per_tick * TIMER_FREQ;
+}
+
 /* Calibrates loops_per_tick, used to implement brief delays. */
 void
 timer_calibrate (void) 
@@ -75,9 +105,15 @@ timer_calibrate (void)
 int64_t
 timer_ticks (void) 
 {
-  enum intr_level old_level = intr_disable ();
-  int64_t t = ticks;
-  intr_set_level (old_level);
+  unsigned seq;
+  int64_t t;
+
+  do
+    {
+      seq = seqlock_read_begin (&ticks_seqlock);
+      t = ticks;
+    }
+  while (seqlock_read_retry (&ticks_seqlock, seq));
   return t;
 }
 
@@ -180,9 +216,16 @@ timer_print_stats (void)
 
 /* Timer interrupt handler. */
 static void
-timer_interrupt (struct intr_frame *args UNUSED)
+timer_interrupt (struct intr_frame *args)
 {
+  profile_sample (args);
+  if (--intrs_left > 0)
+    return;
+  intrs_left = intrs_per_tick;
+
+  seqlock_write_begin (&ticks_seqlock);
   ticks++;
+  seqlock_write_end (&ticks_seqlock);
   thread_tick();
   struct list_elem *iterator = list_begin(&sleeping_list);
   while(iterator != list_end(&sleeping_list))
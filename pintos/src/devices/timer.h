@@ -9,6 +9,7 @@
 
 void timer_init (void);
 void timer_calibrate (void);
+unsigned timer_set_interrupt_freq (unsigned freq);
 
 int64_t timer_ticks (void);
 int64_t timer_elapsed (int64_t);
@@ -1,6 +1,8 @@
 /* lineup.c
 
-   Converts a file to uppercase in-place.
+   Converts a file to uppercase in-place.  Without a file name,
+   copies standard input to standard output in uppercase instead,
+   as in "cat file | lineup".
 
    Incidentally, another way to do this while avoiding the seeks
    would be to open the input file, then remove() it and reopen
@@ -17,6 +19,18 @@ main (int argc, char *argv[])
   char buf[1024];
   int handle;
 
+  if (argc == 1)
+    {
+      int n, i;
+
+      while ((n = read (STDIN_FILENO, buf, sizeof buf)) > 0)
+        {
+          for (i = 0; i < n; i++)
+            buf[i] = toupper ((unsigned char) buf[i]);
+          write (STDOUT_FILENO, buf, n);
+        }
+      return EXIT_SUCCESS;
+    }
   if (argc != 2)
     exit (1);
 
@@ -0,0 +1,69 @@
+/* nullcall.c
+
+   Measures the cost of a system call that does nothing, made
+   first with `int $0x30' and then, if the CPU supports it, with
+   SYSENTER.  Prints the average number of CPU cycles per call
+   for each method.
+
+   Usage: nullcall [ITERATIONS] */
+
+#include <cpu.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <syscall.h>
+
+#define DEFAULT_ITERATIONS 100000
+
+/* Returns the average number of cycles taken by ITERATIONS null
+   system calls made with SYSENTER if FAST is true, or with
+   `int $0x30' otherwise. */
+static uint64_t
+measure (bool fast, int iterations)
+{
+  bool saved = syscall_use_sysenter;
+  uint64_t start, end;
+  int i;
+
+  syscall_use_sysenter = fast;
+  null_syscall ();
+  start = rdtsc ();
+  for (i = 0; i < iterations; i++)
+    null_syscall ();
+  end = rdtsc ();
+  syscall_use_sysenter = saved;
+
+  return (end - start) / iterations;
+}
+
+int
+main (int argc, char *argv[])
+{
+  int iterations = argc > 1 ? atoi (argv[1]) : DEFAULT_ITERATIONS;
+  uint64_t slow, fast;
+
+  if (iterations <= 0)
+    {
+      printf ("usage: nullcall [ITERATIONS]\n");
+      return EXIT_FAILURE;
+    }
+  if (!(cpu_features () & CPU_TSC))
+    {
+      printf ("nullcall: no time-stamp counter\n");
+      return EXIT_FAILURE;
+    }
+
+  slow = measure (false, iterations);
+  printf ("int $0x30: %"PRIu64" cycles/call\n", slow);
+  if (!cpu_has_sysenter ())
+    {
+      printf ("sysenter: not supported\n");
+      return EXIT_SUCCESS;
+    }
+  fast = measure (true, iterations);
+  printf ("sysenter:  %"PRIu64" cycles/call\n", fast);
+  if (fast > 0)
+    printf ("speedup:   %"PRIu64".%02"PRIu64"x\n",
+            slow / fast, slow * 100 / fast % 100);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+/* ringcp.c
+
+   Copies one file to another twice: first with one read() and
+   one write() system call per block, then through a batched I/O
+   ring that moves IORING_ENTRIES / 2 blocks per system call.
+   Prints the time each copy took and the speedup.
+
+   Usage: ringcp OLD NEW */
+
+#include <cpu.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <syscall.h>
+
+#define BLOCK_SIZE 512
+#define BATCH (IORING_ENTRIES / 2)
+
+static struct ioring ring;
+static char blocks[BATCH][BLOCK_SIZE];
+
+/* Returns the current cycle count, or 0 if the CPU has no
+   time-stamp counter. */
+static uint64_t
+now (void)
+{
+  return cpu_features () & CPU_TSC ? rdtsc () : 0;
+}
+
+/* Creates NEW with the given SIZE, replacing any existing file,
+   and returns a file descriptor for it, or -1 on failure. */
+static int
+create_output (const char *new, int size)
+{
+  remove (new);
+  if (!create (new, size))
+    return -1;
+  return open (new);
+}
+
+/* Copies SIZE bytes from IN_FD to OUT_FD with one system call
+   per block read or written.  Returns true if successful. */
+static bool
+copy_plain (int in_fd, int out_fd, int size)
+{
+  int ofs;
+
+  seek (in_fd, 0);
+  for (ofs = 0; ofs < size; ofs += BLOCK_SIZE)
+    {
+      int bytes_read = read (in_fd, blocks[0], BLOCK_SIZE);
+      if (bytes_read <= 0 || write (out_fd, blocks[0], bytes_read) != bytes_read)
+        return false;
+    }
+  return true;
+}
+
+/* Queues a request for OP on FD of SIZE bytes at OFFSET,
+   using BUFFER. */
+static void
+queue (int op, int fd, void *buffer, unsigned size, int offset)
+{
+  struct ioring_sqe *sqe = &ring.sq[ring.sq_tail % IORING_ENTRIES];
+
+  sqe->op = op;
+  sqe->fd = fd;
+  sqe->buffer = buffer;
+  sqe->size = size;
+  sqe->offset = offset;
+  sqe->data = size;
+  ring.sq_tail++;
+}
+
+/* Copies SIZE bytes from IN_FD to OUT_FD through the ring.  The
+   kernel runs requests in order, so each block's write can be
+   queued right behind its read in the same batch.  Returns true
+   if successful. */
+static bool
+copy_ring (int in_fd, int out_fd, int size)
+{
+  int ofs = 0;
+
+  while (ofs < size)
+    {
+      int i;
+
+      for (i = 0; i < BATCH && ofs < size; i++, ofs += BLOCK_SIZE)
+        {
+          int bytes = size - ofs < BLOCK_SIZE ? size - ofs : BLOCK_SIZE;
+          queue (IORING_READ, in_fd, blocks[i], bytes, ofs);
+          queue (IORING_WRITE, out_fd, blocks[i], bytes, ofs);
+        }
+      if (ioring_enter () != 2 * i)
+        return false;
+      for (; ring.cq_head != ring.cq_tail; ring.cq_head++)
+        {
+          struct ioring_cqe *cqe = &ring.cq[ring.cq_head % IORING_ENTRIES];
+          if (cqe->result != (int) cqe->data)
+            return false;
+        }
+    }
+  return true;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint64_t start, plain, ringed;
+  int in_fd, out_fd, size;
+
+  if (argc != 3)
+    {
+      printf ("usage: ringcp OLD NEW\n");
+      return EXIT_FAILURE;
+    }
+
+  in_fd = open (argv[1]);
+  if (in_fd < 0)
+    {
+      printf ("%s: open failed\n", argv[1]);
+      return EXIT_FAILURE;
+    }
+  size = filesize (in_fd);
+  if (!ioring_setup (&ring))
+    {
+      printf ("ringcp: ioring_setup failed\n");
+      return EXIT_FAILURE;
+    }
+
+  /* Copy with plain system calls. */
+  out_fd = create_output (argv[2], size);
+  if (out_fd < 0)
+    {
+      printf ("%s: create failed\n", argv[2]);
+      return EXIT_FAILURE;
+    }
+  start = now ();
+  if (!copy_plain (in_fd, out_fd, size))
+    {
+      printf ("%s: copy failed\n", argv[2]);
+      return EXIT_FAILURE;
+    }
+  plain = now () - start;
+  close (out_fd);
+
+  /* Copy through the ring. */
+  out_fd = create_output (argv[2], size);
+  if (out_fd < 0)
+    {
+      printf ("%s: create failed\n", argv[2]);
+      return EXIT_FAILURE;
+    }
+  start = now ();
+  if (!copy_ring (in_fd, out_fd, size))
+    {
+      printf ("%s: ring copy failed\n", argv[2]);
+      return EXIT_FAILURE;
+    }
+  ringed = now () - start;
+  close (out_fd);
+
+  printf ("copied %d bytes\n", size);
+  printf ("plain: %"PRIu64" cycles\n", plain);
+  printf ("ring:  %"PRIu64" cycles\n", ringed);
+  if (ringed > 0)
+    printf ("speedup: %"PRIu64".%02"PRIu64"x\n",
+            plain / ringed, plain * 100 / ringed % 100);
+  return EXIT_SUCCESS;
+}
@@ -3,7 +3,12 @@
 #include <string.h>
 #include <syscall.h>
 
+/* Maximum number of commands in a pipeline. */
+#define MAX_STAGES 8
+
+static void run_pipeline (char *command);
 static void read_line (char line[], size_t);
+static char read_char (void);
 static bool backspace (char **pos, char line[]);
 
 int
@@ -30,6 +35,8 @@ main (void)
         {
           /* Empty command. */
         }
+      else if (strchr (command, '|') != NULL)
+        run_pipeline (command);
       else
         {
           pid_t pid = exec (command);
@@ -44,6 +51,77 @@ main (void)
   return EXIT_SUCCESS;
 }
 
+/* Runs COMMAND, a pipeline of commands separated by `|', with
+   each command's standard output connected to the next one's
+   standard input, and reports each command's exit code.
+
+   The shell points its own fd 0 and fd 1 at the right pipe ends
+   with dup2() while it starts each command, which inherits them,
+   then closes them again to get the console back. */
+static void
+run_pipeline (char *command)
+{
+  char *stages[MAX_STAGES];
+  pid_t pids[MAX_STAGES];
+  char *stage, *save_ptr;
+  int stage_cnt = 0;
+  int i;
+
+  for (stage = strtok_r (command, "|", &save_ptr); stage != NULL;
+       stage = strtok_r (NULL, "|", &save_ptr))
+    {
+      char *end;
+
+      if (stage_cnt >= MAX_STAGES)
+        {
+          printf ("too many commands in pipeline\n");
+          return;
+        }
+      while (*stage == ' ')
+        stage++;
+      for (end = stage + strlen (stage); end > stage && end[-1] == ' '; )
+        *--end = '\0';
+      if (*stage == '\0')
+        {
+          printf ("empty command in pipeline\n");
+          return;
+        }
+      stages[stage_cnt++] = stage;
+    }
+
+  for (i = 0; i < stage_cnt; i++)
+    {
+      int fds[2] = {-1, -1};
+
+      if (i + 1 < stage_cnt)
+        {
+          if (!pipe (fds))
+            {
+              printf ("pipe failed\n");
+              stage_cnt = i;
+              break;
+            }
+          dup2 (fds[1], STDOUT_FILENO);
+          close (fds[1]);
+        }
+      pids[i] = exec (stages[i]);
+      close (STDIN_FILENO);
+      close (STDOUT_FILENO);
+      if (fds[0] >= 0)
+        {
+          dup2 (fds[0], STDIN_FILENO);
+          close (fds[0]);
+        }
+    }
+  close (STDIN_FILENO);
+
+  for (i = 0; i < stage_cnt; i++)
+    if (pids[i] != PID_ERROR)
+      printf ("\"%s\": exit code %d\n", stages[i], wait (pids[i]));
+    else
+      printf ("\"%s\": exec failed\n", stages[i]);
+}
+
 /* Reads a line of input from the user into LINE, which has room
    for SIZE bytes.  Handles backspace and Ctrl+U in the ways
    expected by Unix users.  On return, LINE will always be
@@ -54,12 +132,12 @@ read_line (char line[], size_t size)
   char *pos = line;
   for (;;)
     {
-      char c;
-      read (STDIN_FILENO, &c, 1);
+      char c = read_char ();
 
       switch (c) 
         {
         case '\r':
+        case '\n':
           *pos = '\0';
           putchar ('\n');
           return;
@@ -102,3 +180,21 @@ backspace (char **pos, char line[])
   else
     return false;
 }
+
+/* Returns the next byte of input.  Reads input in blocks, so
+   that input piped in through the serial port does not cost a
+   system call per byte.  Input read ahead this way is not seen
+   by the programs that the shell runs. */
+static char
+read_char (void) 
+{
+  static char buf[256];
+  static int ofs, len;
+
+  while (ofs >= len)
+    {
+      len = read (STDIN_FILENO, buf, sizeof buf);
+      ofs = 0;
+    }
+  return buf[ofs++];
+}
@@ -0,0 +1,45 @@
+/* stats.c
+
+   Prints the kernel's statistics, in the format described in
+   threads/stats.h, optionally only those whose names begin with
+   PREFIX, e.g. "syscall." or "lock.".
+
+   Usage: stats [PREFIX] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syscall.h>
+
+/* Buffer for the statistics text. */
+static char buf[16384];
+
+int
+main (int argc, char *argv[])
+{
+  const char *prefix = argc > 1 ? argv[1] : "";
+  size_t prefix_len = strlen (prefix);
+  int length = stats (buf, sizeof buf);
+  char *line, *end;
+
+  if (length > (int) sizeof buf)
+    {
+      printf ("stats: output truncated to %zu of %d bytes\n",
+              sizeof buf, length);
+      length = sizeof buf;
+    }
+
+  /* Each line is "counter NAME ..." or "hist NAME ...". */
+  for (line = buf; line < buf + length; line = end + 1)
+    {
+      char *name = strchr (line, ' ');
+
+      end = memchr (line, '\n', buf + length - line);
+      if (end == NULL)
+        break;
+      if (name != NULL && (size_t) (end - name) > prefix_len
+          && !memcmp (name + 1, prefix, prefix_len))
+        write (STDOUT_FILENO, line, end - line + 1);
+    }
+  return EXIT_SUCCESS;
+}
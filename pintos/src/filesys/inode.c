@@ -1,6 +1,7 @@
 #include "filesys/inode.h"
-#include <list.h>
 #include <debug.h>
+#include <hash.h>
+#include <ohash.h>
 #include <round.h>
 #include <string.h>
 #include "filesys/filesys.h"
@@ -31,14 +32,27 @@ bytes_to_sectors (off_t size)
 /* In-memory inode. */
 struct inode 
   {
-    struct list_elem elem;              /* Element in inode list. */
+    struct ohash_elem elem;             /* Element in open_inodes. */
     block_sector_t sector;              /* Sector number of disk location. */
     int open_cnt;                       /* Number of openers. */
     bool removed;                       /* True if deleted, false otherwise. */
     int deny_write_cnt;                 /* 0: writes ok, >0: deny writes. */
+    unsigned version;                   /* Changes on write or removal. */
+    inode_watch_func *watch;            /* Called on write or removal. */
     struct inode_disk data;             /* Inode content. */
   };
 
+/* Records that INODE's data has been written or that INODE has
+   been removed, by bumping its version and calling its
+   watcher. */
+static void
+changed (struct inode *inode) 
+{
+  inode->version++;
+  if (inode->watch != NULL)
+    inode->watch (inode);
+}
+
 /* Returns the block device sector that contains byte offset POS
    within INODE.
    Returns -1 if INODE does not contain data for a byte at offset
@@ -53,15 +67,19 @@ byte_to_sector (const struct inode *inode, off_t pos)
     return -1;
 }
 
-/* List of open inodes, so that opening a single inode twice
-   returns the same `struct inode'. */
-static struct list open_inodes;
+/* Open inodes, indexed by sector, so that opening a single
+   inode twice returns the same `struct inode'. */
+static struct ohash open_inodes;
+
+static ohash_hash_func inode_hash;
+static ohash_less_func inode_less;
 
 /* Initializes the inode module. */
 void
 inode_init (void) 
 {
-  list_init (&open_inodes);
+  if (!ohash_init (&open_inodes, inode_hash, inode_less, NULL))
+    PANIC ("can't allocate open inode table");
 }
 
 /* Initializes an inode with LENGTH bytes of data and
@@ -111,19 +129,18 @@ inode_create (block_sector_t sector, off_t length)
 struct inode *
 inode_open (block_sector_t sector)
 {
-  struct list_elem *e;
+  struct inode key;
+  struct ohash_elem *e;
   struct inode *inode;
 
   /* Check whether this inode is already open. */
-  for (e = list_begin (&open_inodes); e != list_end (&open_inodes);
-       e = list_next (e)) 
+  key.sector = sector;
+  e = ohash_find (&open_inodes, &key.elem);
+  if (e != NULL) 
     {
-      inode = list_entry (e, struct inode, elem);
-      if (inode->sector == sector) 
-        {
-          inode_reopen (inode);
-          return inode; 
-        }
+      inode = ohash_entry (e, struct inode, elem);
+      inode_reopen (inode);
+      return inode; 
     }
 
   /* Allocate memory. */
@@ -132,11 +149,13 @@ inode_open (block_sector_t sector)
     return NULL;
 
   /* Initialize. */
-  list_push_front (&open_inodes, &inode->elem);
   inode->sector = sector;
+  ohash_insert (&open_inodes, &inode->elem);
   inode->open_cnt = 1;
   inode->deny_write_cnt = 0;
   inode->removed = false;
+  inode->version = 0;
+  inode->watch = NULL;
   block_read (fs_device, inode->sector, &inode->data);
   return inode;
 }
@@ -170,8 +189,8 @@ inode_close (struct inode *inode)
   /* Release resources if this was the last opener. */
   if (--inode->open_cnt == 0)
     {
-      /* Remove from inode list and release lock. */
-      list_remove (&inode->elem);
+      /* Remove from inode table and release lock. */
+      ohash_delete (&open_inodes, &inode->elem);
  
       /* Deallocate blocks if removed. */
       if (inode->removed) 
@@ -192,6 +211,7 @@ inode_remove (struct inode *inode)
 {
   ASSERT (inode != NULL);
   inode->removed = true;
+  changed (inode);
 }
 
 /* Reads SIZE bytes from INODE into BUFFER, starting at position OFFSET.
@@ -265,6 +285,14 @@ inode_write_at (struct inode *inode, const void *buffer_, off_t size,
   if (inode->deny_write_cnt)
     return 0;
 
+  /* Mark INODE changed both before and after writing.  A reader
+     that checks inode_version() before and after reading data
+     derived from INODE, as the executable image cache in
+     userprog/process.c does, then sees a change if any part of
+     the write overlapped its reading, even if the reading
+     started after the write began. */
+  changed (inode);
+
   while (size > 0) 
     {
       /* Sector to write, starting byte offset within sector. */
@@ -313,6 +341,7 @@ inode_write_at (struct inode *inode, const void *buffer_, off_t size,
       bytes_written += chunk_size;
     }
   free (bounce);
+  changed (inode);
 
   return bytes_written;
 }
@@ -337,9 +366,47 @@ inode_allow_write (struct inode *inode)
   inode->deny_write_cnt--;
 }
 
+/* Returns a number that changes whenever INODE's data is written
+   or INODE is removed, for use by caches of data derived from
+   INODE.  It stays the same only for as long as INODE is kept
+   open. */
+unsigned
+inode_version (const struct inode *inode)
+{
+  return inode->version;
+}
+
+/* Arranges for WATCH to be called with INODE, which the caller
+   must keep open, each time INODE is written or removed, or
+   cancels that if WATCH is a null pointer.  Lets a cache of data
+   derived from INODE drop it as soon as it goes stale.  An inode
+   has at most one watcher. */
+void
+inode_watch (struct inode *inode, inode_watch_func *watch)
+{
+  inode->watch = watch;
+}
+
 /* Returns the length, in bytes, of INODE's data. */
 off_t
 inode_length (const struct inode *inode)
 {
   return inode->data.length;
 }
+
+/* Returns a hash value for the sector of the inode that contains
+   E. */
+static unsigned
+inode_hash (const struct ohash_elem *e, void *aux UNUSED)
+{
+  return hash_int (ohash_entry (e, struct inode, elem)->sector);
+}
+
+/* Returns true if inode A's sector is less than inode B's. */
+static bool
+inode_less (const struct ohash_elem *a, const struct ohash_elem *b,
+            void *aux UNUSED)
+{
+  return (ohash_entry (a, struct inode, elem)->sector
+          < ohash_entry (b, struct inode, elem)->sector);
+}
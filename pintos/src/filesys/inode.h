@@ -6,6 +6,11 @@
 #include "devices/block.h"
 
 struct bitmap;
+struct inode;
+
+/* Function that inode_watch() arranges to be called with an inode
+   whenever it is written or removed. */
+typedef void inode_watch_func (struct inode *);
 
 void inode_init (void);
 bool inode_create (block_sector_t, off_t);
@@ -19,5 +24,7 @@ off_t inode_write_at (struct inode *, const void *, off_t size, off_t offset);
 void inode_deny_write (struct inode *);
 void inode_allow_write (struct inode *);
 off_t inode_length (const struct inode *);
+unsigned inode_version (const struct inode *);
+void inode_watch (struct inode *, inode_watch_func *);
 
 #endif /* filesys/inode.h */
@@ -0,0 +1,86 @@
+#ifndef __LIB_CPU_H
+#define __LIB_CPU_H
+
+/* Processor feature detection and cycle counting.  These work
+   the same in the kernel and in user programs, so that both can
+   agree on which features to use. */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Feature bits in EDX from CPUID leaf 1. */
+#define CPU_TSC (1u << 4)       /* Time-stamp counter (RDTSC). */
+#define CPU_SEP (1u << 11)      /* SYSENTER and SYSEXIT. */
+
+/* Returns true if the CPU implements the CPUID instruction,
+   which is the case if the ID bit (bit 21) in EFLAGS can be
+   toggled. */
+static inline bool
+cpuid_supported (void)
+{
+  uint32_t old_flags, new_flags;
+
+  asm volatile ("pushfl; popl %0; movl %0, %1; xorl $0x200000, %0; "
+                "pushl %0; popfl; pushfl; popl %0; pushl %1; popfl"
+                : "=&r" (new_flags), "=&r" (old_flags) : : "cc");
+  return ((new_flags ^ old_flags) & 0x200000) != 0;
+}
+
+/* Executes CPUID for LEAF and stores the resulting registers in
+   *EAX, *EBX, *ECX, and *EDX. */
+static inline void
+cpuid (uint32_t leaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx,
+       uint32_t *edx)
+{
+  asm volatile ("cpuid"
+                : "=a" (*eax), "=b" (*ebx), "=c" (*ecx), "=d" (*edx)
+                : "a" (leaf), "c" (0));
+}
+
+/* Returns the CPU's leaf 1 feature bits from EDX, or 0 if the
+   CPU cannot report them. */
+static inline uint32_t
+cpu_features (void)
+{
+  uint32_t eax, ebx, ecx, edx;
+
+  if (!cpuid_supported ())
+    return 0;
+  cpuid (0, &eax, &ebx, &ecx, &edx);
+  if (eax < 1)
+    return 0;
+  cpuid (1, &eax, &ebx, &ecx, &edx);
+  return edx;
+}
+
+/* Returns true if SYSENTER and SYSEXIT may be used. */
+static inline bool
+cpu_has_sysenter (void)
+{
+  uint32_t eax, ebx, ecx, edx;
+  unsigned family, model, stepping;
+
+  if (!(cpu_features () & CPU_SEP))
+    return false;
+
+  /* Early Pentium Pro processors report SEP without actually
+     supporting the instructions. */
+  cpuid (1, &eax, &ebx, &ecx, &edx);
+  family = (eax >> 8) & 0xf;
+  model = (eax >> 4) & 0xf;
+  stepping = eax & 0xf;
+  return !(family == 6 && model < 3 && stepping < 3);
+}
+
+/* Returns the value of the time-stamp counter.  Only valid if
+   cpu_features() includes CPU_TSC. */
+static inline uint64_t
+rdtsc (void)
+{
+  uint64_t tsc;
+
+  asm volatile ("rdtsc" : "=A" (tsc));
+  return tsc;
+}
+
+#endif /* lib/cpu.h */
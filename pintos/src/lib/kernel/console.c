@@ -1,14 +1,20 @@
 #include <console.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 #include "devices/serial.h"
 #include "devices/vga.h"
 #include "threads/init.h"
 #include "threads/interrupt.h"
 #include "threads/synch.h"
+#include "threads/thread.h"
 
 static void vprintf_helper (char, void *);
 static void putchar_have_lock (uint8_t c);
+static void putbuf_have_lock (const char *, size_t);
+static void write_devices (const char *, size_t);
+static void drain_ring (void);
+static thread_func console_thread;
 
 /* The console lock.
    Both the vga and serial layers do their own locking, so it's
@@ -59,6 +65,35 @@ static int console_lock_depth;
 /* Number of characters written to console. */
 static int64_t write_cnt;
 
+/* Console output ring.
+
+   After console_start(), output is copied into this ring instead
+   of being written straight to the serial port and the VGA
+   display, and a console thread writes it to them in bulk.  A
+   thread that prints a lot therefore holds the console lock only
+   for as long as it takes to copy its output, not for as long as
+   the devices take to accept it.  Output reaches the devices in
+   the order it entered the ring.
+
+   The ring is protected by disabling interrupts, so interrupt
+   handlers may print too.  When the ring is full, a thread waits
+   for the console thread to make room, but an interrupt handler
+   or code running with interrupts off cannot wait, so it writes
+   directly to the devices, possibly ahead of older output. */
+#define RING_SIZE 4096
+static char ring[RING_SIZE];
+static unsigned ring_head;      /* Total bytes ever added. */
+static unsigned ring_tail;      /* Total bytes ever removed. */
+static bool use_ring;           /* Is the console thread running? */
+
+static struct semaphore ring_data;  /* Upped when the ring becomes nonempty. */
+static struct semaphore ring_space; /* Upped once per waiter for room. */
+static unsigned space_waiters;      /* Threads waiting for room. */
+
+/* Held by the console thread while it writes output removed from
+   the ring, so that console_flush() cannot overtake it. */
+static struct lock drain_lock;
+
 /* Enable console locking. */
 void
 console_init (void) 
@@ -67,13 +102,51 @@ console_init (void)
   use_console_lock = true;
 }
 
+/* Starts the console thread and begins buffering output in the
+   console ring.  Must be called after thread_start(). */
+void
+console_start (void) 
+{
+  sema_init (&ring_data, 0);
+  sema_init (&ring_space, 0);
+  lock_init (&drain_lock);
+  if (thread_create ("console", PRI_DEFAULT, console_thread, NULL)
+      == TID_ERROR)
+    return;
+  use_ring = true;
+}
+
+/* Writes all the output buffered in the console ring to the
+   devices before returning. */
+void
+console_flush (void) 
+{
+  if (!use_ring)
+    return;
+  if (!intr_context () && intr_get_level () == INTR_ON && use_console_lock)
+    {
+      lock_acquire (&drain_lock);
+      drain_ring ();
+      lock_release (&drain_lock);
+    }
+  else
+    drain_ring ();
+}
+
 /* Notifies the console that a kernel panic is underway,
    which warns it to avoid trying to take the console lock from
-   now on. */
+   now on.  Also stops buffering output and writes out whatever
+   is in the console ring, so that the panic message is not lost
+   behind it. */
 void
 console_panic (void) 
 {
   use_console_lock = false;
+  if (use_ring)
+    {
+      use_ring = false;
+      drain_ring ();
+    }
 }
 
 /* Prints console statistics. */
@@ -119,19 +192,30 @@ console_locked_by_current_thread (void)
           || lock_held_by_current_thread (&console_lock));
 }
 
+/* Output accumulated by vprintf_helper(). */
+struct vprintf_aux
+  {
+    char buf[64];               /* Characters not yet written. */
+    size_t len;                 /* Number of characters in buf. */
+    int char_cnt;               /* Total characters printed. */
+  };
+
 /* The standard vprintf() function,
    which is like printf() but uses a va_list.
    Writes its output to both vga display and serial port. */
 int
 vprintf (const char *format, va_list args) 
 {
-  int char_cnt = 0;
+  struct vprintf_aux aux;
 
+  aux.len = 0;
+  aux.char_cnt = 0;
   acquire_console ();
-  __vprintf (format, args, vprintf_helper, &char_cnt);
+  __vprintf (format, args, vprintf_helper, &aux);
+  putbuf_have_lock (aux.buf, aux.len);
   release_console ();
 
-  return char_cnt;
+  return aux.char_cnt;
 }
 
 /* Writes string S to the console, followed by a new-line
@@ -140,8 +224,7 @@ int
 puts (const char *s) 
 {
   acquire_console ();
-  while (*s != '\0')
-    putchar_have_lock (*s++);
+  putbuf_have_lock (s, strlen (s));
   putchar_have_lock ('\n');
   release_console ();
 
@@ -153,8 +236,7 @@ void
 putbuf (const char *buffer, size_t n) 
 {
   acquire_console ();
-  while (n-- > 0)
-    putchar_have_lock (*buffer++);
+  putbuf_have_lock (buffer, n);
   release_console ();
 }
 
@@ -171,11 +253,17 @@ putchar (int c)
 
 /* Helper function for vprintf(). */
 static void
-vprintf_helper (char c, void *char_cnt_) 
+vprintf_helper (char c, void *aux_) 
 {
-  int *char_cnt = char_cnt_;
-  (*char_cnt)++;
-  putchar_have_lock (c);
+  struct vprintf_aux *aux = aux_;
+
+  aux->char_cnt++;
+  aux->buf[aux->len++] = c;
+  if (aux->len >= sizeof aux->buf)
+    {
+      putbuf_have_lock (aux->buf, aux->len);
+      aux->len = 0;
+    }
 }
 
 /* Writes C to the vga display and serial port.
@@ -184,8 +272,103 @@ vprintf_helper (char c, void *char_cnt_)
 static void
 putchar_have_lock (uint8_t c) 
 {
+  char ch = c;
+  putbuf_have_lock (&ch, 1);
+}
+
+/* Writes the N characters in BUFFER to the vga display and
+   serial port, by way of the console ring if it is in use.  The
+   caller has already acquired the console lock if
+   appropriate. */
+static void
+putbuf_have_lock (const char *buffer, size_t n) 
+{
+  enum intr_level old_level;
+
   ASSERT (console_locked_by_current_thread ());
-  write_cnt++;
-  serial_putc (c);
-  vga_putc (c);
+  write_cnt += n;
+  if (!use_ring)
+    {
+      write_devices (buffer, n);
+      return;
+    }
+
+  old_level = intr_disable ();
+  while (n > 0)
+    {
+      size_t space = RING_SIZE - (ring_head - ring_tail);
+      size_t ofs = ring_head % RING_SIZE;
+      size_t chunk;
+
+      if (space == 0)
+        {
+          if (intr_context () || old_level == INTR_OFF || !use_ring)
+            {
+              write_devices (buffer, n);
+              break;
+            }
+          space_waiters++;
+          sema_down (&ring_space);
+          continue;
+        }
+
+      chunk = n < space ? n : space;
+      if (chunk > RING_SIZE - ofs)
+        chunk = RING_SIZE - ofs;
+      memcpy (ring + ofs, buffer, chunk);
+      if (ring_head == ring_tail)
+        sema_up (&ring_data);
+      ring_head += chunk;
+      buffer += chunk;
+      n -= chunk;
+    }
+  intr_set_level (old_level);
+}
+
+/* Writes the N characters in BUFFER to the serial port and the
+   vga display. */
+static void
+write_devices (const char *buffer, size_t n) 
+{
+  serial_putbuf (buffer, n);
+  vga_putbuf (buffer, n);
+}
+
+/* Removes output from the console ring and writes it to the
+   devices, until the ring is empty. */
+static void
+drain_ring (void) 
+{
+  enum intr_level old_level = intr_disable ();
+
+  while (ring_head != ring_tail)
+    {
+      char chunk[128];
+      size_t n = 0;
+
+      while (n < sizeof chunk && ring_tail != ring_head)
+        chunk[n++] = ring[ring_tail++ % RING_SIZE];
+      for (; space_waiters > 0; space_waiters--)
+        sema_up (&ring_space);
+
+      intr_set_level (old_level);
+      write_devices (chunk, n);
+      intr_disable ();
+    }
+
+  intr_set_level (old_level);
+}
+
+/* Console thread.  Writes output from the console ring to the
+   devices whenever there is some. */
+static void
+console_thread (void *aux UNUSED) 
+{
+  for (;;)
+    {
+      sema_down (&ring_data);
+      lock_acquire (&drain_lock);
+      drain_ring ();
+      lock_release (&drain_lock);
+    }
 }
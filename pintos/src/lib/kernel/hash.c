@@ -7,6 +7,7 @@
 
 #include "hash.h"
 #include "../debug.h"
+#include <string.h>
 #include "threads/malloc.h"
 
 #define list_elem_to_hash_elem(LIST_ELEM)                       \
@@ -257,50 +258,108 @@ hash_empty (struct hash *h)
   return h->elem_cnt == 0;
 }
 
-/* Fowler-Noll-Vo hash constants, for 32-bit word sizes. */
-#define FNV_32_PRIME 16777619u
-#define FNV_32_BASIS 2166136261u
+/* The sample hash functions are based on MurmurHash3's 32-bit
+   variant, which mixes in a whole word per step, unlike the
+   byte-at-a-time Fowler-Noll-Vo hash that Pintos used to use.
+   Every bit of the result depends on every bit of the input, so
+   the low bits that select a bucket are as good as any. */
+#define MURMUR_C1 0xcc9e2d51u
+#define MURMUR_C2 0x1b873593u
+#define MURMUR_SEED 0x9747b28cu
+
+/* A possibly misaligned word, which x86 allows. */
+typedef uint32_t __attribute__ ((may_alias, aligned (1))) uword_t;
+
+/* Returns X rotated left by R bits. */
+static inline uint32_t
+rotl32 (uint32_t x, int r)
+{
+  return (x << r) | (x >> (32 - r));
+}
+
+/* Scrambles K, a word of input, before it is mixed in. */
+static inline uint32_t
+murmur_scramble (uint32_t k)
+{
+  k *= MURMUR_C1;
+  k = rotl32 (k, 15);
+  k *= MURMUR_C2;
+  return k;
+}
+
+/* Finishes a hash value H, so that each bit of the input
+   affects each bit of the output. */
+static inline uint32_t
+murmur_fmix (uint32_t h)
+{
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
 
 /* Returns a hash of the SIZE bytes in BUF. */
 unsigned
 hash_bytes (const void *buf_, size_t size)
 {
-  /* Fowler-Noll-Vo 32-bit hash, for bytes. */
-  const unsigned char *buf = buf_;
-  unsigned hash;
+  const uint8_t *buf = buf_;
+  uint32_t hash = MURMUR_SEED;
+  uint32_t k;
+  size_t i;
 
   ASSERT (buf != NULL);
 
-  hash = FNV_32_BASIS;
-  while (size-- > 0)
-    hash = (hash * FNV_32_PRIME) ^ *buf++;
+  /* Whole words. */
+  for (i = 0; i < size / 4; i++, buf += 4)
+    {
+      hash ^= murmur_scramble (*(const uword_t *) buf);
+      hash = rotl32 (hash, 13);
+      hash = hash * 5 + 0xe6546b64u;
+    }
 
-  return hash;
+  /* Leftover bytes. */
+  k = 0;
+  switch (size % 4)
+    {
+    case 3:
+      k ^= buf[2] << 16;
+      /* Fall through. */
+    case 2:
+      k ^= buf[1] << 8;
+      /* Fall through. */
+    case 1:
+      k ^= buf[0];
+      hash ^= murmur_scramble (k);
+    }
+
+  return murmur_fmix (hash ^ size);
 } 
 
 /* Returns a hash of string S. */
 unsigned
-hash_string (const char *s_) 
+hash_string (const char *s) 
 {
-  const unsigned char *s = (const unsigned char *) s_;
-  unsigned hash;
-
   ASSERT (s != NULL);
 
-  hash = FNV_32_BASIS;
-  while (*s != '\0')
-    hash = (hash * FNV_32_PRIME) ^ *s++;
-
-  return hash;
+  return hash_bytes (s, strlen (s));
 }
 
 /* Returns a hash of integer I. */
 unsigned
 hash_int (int i) 
 {
-  return hash_bytes (&i, sizeof i);
+  return murmur_fmix (i);
 }
-
+
+/* Returns a hash of pointer P. */
+unsigned
+hash_ptr (const void *p) 
+{
+  return murmur_fmix ((uintptr_t) p);
+}
+
 /* Returns the bucket in H that E belongs in. */
 static struct list *
 find_bucket (struct hash *h, struct hash_elem *e) 
@@ -0,0 +1,203 @@
+#include "heap.h"
+#include "../debug.h"
+
+/* Our pairing heap is a multiway tree in which every element is
+   greater than or equal to all of its children.  Each element
+   points to its leftmost child and to its right sibling.  Its
+   `prev' member points to its left sibling or, for a leftmost
+   child, to its parent, so that an arbitrary element can be cut
+   out of the tree in constant time.
+
+   Insertion links the new element with the root.  Removing an
+   element combines its children in two passes, pairing them off
+   from left to right and then linking the pairs from right to
+   left, which gives the amortized bounds stated in heap.h. */
+
+/* Returns true if element A belongs above element B in heap H,
+   that is, if A is greater than B or if they are equal but A was
+   inserted first. */
+static inline bool
+above (const struct heap *h, const struct heap_elem *a,
+       const struct heap_elem *b)
+{
+  if (h->less (b, a, h->aux))
+    return true;
+  if (h->less (a, b, h->aux))
+    return false;
+  return (int) (a->seq - b->seq) < 0;
+}
+
+/* Links the trees rooted at A and B, either of which may be
+   null, and returns the root of the combined tree.  A and B
+   must not have siblings. */
+static struct heap_elem *
+link (const struct heap *h, struct heap_elem *a, struct heap_elem *b)
+{
+  if (a == NULL)
+    return b;
+  if (b == NULL)
+    return a;
+  if (above (h, b, a))
+    {
+      struct heap_elem *t = a;
+      a = b;
+      b = t;
+    }
+
+  /* Make B the leftmost child of A. */
+  b->prev = a;
+  b->next = a->child;
+  if (a->child != NULL)
+    a->child->prev = b;
+  a->child = b;
+  return a;
+}
+
+/* Combines the sibling list beginning at FIRST into a single
+   tree and returns its root, or a null pointer if FIRST is
+   null. */
+static struct heap_elem *
+combine (const struct heap *h, struct heap_elem *first)
+{
+  struct heap_elem *pairs = NULL;
+  struct heap_elem *root = NULL;
+
+  /* First pass: link siblings in pairs, left to right, pushing
+     each result onto the PAIRS stack. */
+  while (first != NULL)
+    {
+      struct heap_elem *a = first;
+      struct heap_elem *b = a->next;
+      struct heap_elem *pair;
+
+      first = b != NULL ? b->next : NULL;
+      a->next = a->prev = NULL;
+      if (b != NULL)
+        b->next = b->prev = NULL;
+      pair = link (h, a, b);
+      pair->next = pairs;
+      pairs = pair;
+    }
+
+  /* Second pass: link the pairs right to left. */
+  while (pairs != NULL)
+    {
+      struct heap_elem *next = pairs->next;
+      pairs->next = NULL;
+      root = link (h, root, pairs);
+      pairs = next;
+    }
+  return root;
+}
+
+/* Cuts the subtree rooted at E, which must not be the root of
+   its heap, out of the tree that contains it. */
+static void
+cut (struct heap_elem *e)
+{
+  if (e->prev->child == e)
+    e->prev->child = e->next;
+  else
+    e->prev->next = e->next;
+  if (e->next != NULL)
+    e->next->prev = e->prev;
+  e->next = e->prev = NULL;
+}
+
+/* Initializes H as an empty heap ordered by LESS given auxiliary
+   data AUX. */
+void
+heap_init (struct heap *h, heap_less_func *less, void *aux)
+{
+  ASSERT (h != NULL);
+  ASSERT (less != NULL);
+
+  h->root = NULL;
+  h->size = 0;
+  h->next_seq = 0;
+  h->less = less;
+  h->aux = aux;
+}
+
+/* Inserts E into H. */
+void
+heap_insert (struct heap *h, struct heap_elem *e)
+{
+  ASSERT (h != NULL);
+  ASSERT (e != NULL);
+
+  e->child = e->next = e->prev = NULL;
+  e->seq = h->next_seq++;
+  h->root = link (h, h->root, e);
+  h->size++;
+}
+
+/* Removes E, which must be in H, and returns it. */
+struct heap_elem *
+heap_remove (struct heap *h, struct heap_elem *e)
+{
+  struct heap_elem *children;
+
+  ASSERT (h != NULL);
+  ASSERT (e != NULL);
+  ASSERT (h->size > 0);
+
+  children = e->child;
+  e->child = NULL;
+  if (e == h->root)
+    h->root = combine (h, children);
+  else
+    {
+      cut (e);
+      h->root = link (h, h->root, combine (h, children));
+    }
+  h->size--;
+  return e;
+}
+
+/* Restores H's ordering after the value that E, which must be
+   in H, is ordered by has changed.  E keeps its original place
+   among elements that compare equal to it. */
+void
+heap_update (struct heap *h, struct heap_elem *e)
+{
+  heap_remove (h, e);
+  e->child = e->next = e->prev = NULL;
+  h->root = link (h, h->root, e);
+  h->size++;
+}
+
+/* Returns the greatest element in H.
+   Undefined behavior if H is empty. */
+struct heap_elem *
+heap_front (struct heap *h)
+{
+  ASSERT (h != NULL);
+  ASSERT (h->root != NULL);
+
+  return h->root;
+}
+
+/* Removes the greatest element from H and returns it.
+   Undefined behavior if H is empty. */
+struct heap_elem *
+heap_pop_front (struct heap *h)
+{
+  return heap_remove (h, heap_front (h));
+}
+
+/* Returns the number of elements in H. */
+size_t
+heap_size (struct heap *h)
+{
+  ASSERT (h != NULL);
+
+  return h->size;
+}
+
+/* Returns true if H is empty, false otherwise. */
+bool
+heap_empty (struct heap *h)
+{
+  return heap_size (h) == 0;
+}
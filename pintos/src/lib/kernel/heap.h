@@ -0,0 +1,81 @@
+#ifndef __LIB_KERNEL_HEAP_H
+#define __LIB_KERNEL_HEAP_H
+
+/* Priority queue (max-heap).
+
+   This is a pairing heap.  Like the linked list in list.h, it
+   does not require use of dynamically allocated memory.
+   Instead, each structure that can potentially be in a heap
+   must embed a struct heap_elem member.  All of the heap
+   functions operate on these `struct heap_elem's.  The
+   heap_entry macro allows conversion from a struct heap_elem
+   back to a structure object that contains it.
+
+   The heap is ordered by a heap_less_func supplied to
+   heap_init().  heap_front() returns the greatest element.
+   Elements that compare equal are returned in the order they
+   were inserted, so a heap can stand in for a list kept sorted
+   with list_insert_ordered().
+
+   Costs, with N elements in the heap:
+
+     - heap_insert(), heap_front(): O(1).
+
+     - heap_pop_front(), heap_remove(), heap_update(): O(lg N)
+       amortized.
+
+   If the value that an element is ordered by changes while the
+   element is in a heap, heap_update() must be called to restore
+   the heap's ordering before any other operation on the heap. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Heap element. */
+struct heap_elem
+  {
+    struct heap_elem *child;    /* Leftmost child. */
+    struct heap_elem *next;     /* Next sibling to the right. */
+    struct heap_elem *prev;     /* Left sibling, or parent if leftmost. */
+    unsigned seq;               /* Insertion order, for tie breaking. */
+  };
+
+/* Converts pointer to heap element HEAP_ELEM into a pointer to
+   the structure that HEAP_ELEM is embedded inside.  Supply the
+   name of the outer structure STRUCT and the member name MEMBER
+   of the heap element. */
+#define heap_entry(HEAP_ELEM, STRUCT, MEMBER)           \
+        ((STRUCT *) ((uint8_t *) &(HEAP_ELEM)->child    \
+                     - offsetof (STRUCT, MEMBER.child)))
+
+/* Compares the value of two heap elements A and B, given
+   auxiliary data AUX.  Returns true if A is less than B, or
+   false if A is greater than or equal to B. */
+typedef bool heap_less_func (const struct heap_elem *a,
+                             const struct heap_elem *b,
+                             void *aux);
+
+/* Heap. */
+struct heap
+  {
+    struct heap_elem *root;     /* Greatest element, or null. */
+    size_t size;                /* Number of elements. */
+    unsigned next_seq;          /* Next insertion sequence number. */
+    heap_less_func *less;       /* Comparison function. */
+    void *aux;                  /* Auxiliary data for `less'. */
+  };
+
+void heap_init (struct heap *, heap_less_func *, void *aux);
+
+void heap_insert (struct heap *, struct heap_elem *);
+struct heap_elem *heap_remove (struct heap *, struct heap_elem *);
+void heap_update (struct heap *, struct heap_elem *);
+
+struct heap_elem *heap_front (struct heap *);
+struct heap_elem *heap_pop_front (struct heap *);
+
+size_t heap_size (struct heap *);
+bool heap_empty (struct heap *);
+
+#endif /* lib/kernel/heap.h */
@@ -0,0 +1,454 @@
+/* Open-addressing hash table.
+
+   See ohash.h for basic information. */
+
+#include "ohash.h"
+#include "../debug.h"
+#include <string.h>
+#include "threads/malloc.h"
+
+/* Number of slots in a newly initialized table. */
+#define MIN_SLOT_CNT 8
+
+/* Number of slots of the old table to migrate per insertion or
+   deletion while a resize is in progress.  A resize starts when
+   the new table will be at most 3/8 full, so the old table is
+   empty long before the new one needs to grow again. */
+#define MIGRATE_CNT 4
+
+static size_t find_slot (struct ohash *, struct ohash_table *,
+                         unsigned hash, struct ohash_elem *);
+static void put_slot (struct ohash_table *, struct ohash_slot);
+static void remove_slot (struct ohash_table *, size_t idx);
+static void migrate (struct ohash *, size_t cnt);
+static void grow (struct ohash *);
+
+/* Returned by find_slot() for an element that is not present. */
+#define NOT_FOUND SIZE_MAX
+
+/* Initializes hash table H to compute hash values using HASH and
+   compare hash elements using LESS, given auxiliary data AUX.
+   Returns true if successful, false if memory allocation
+   fails. */
+bool
+ohash_init (struct ohash *h,
+            ohash_hash_func *hash, ohash_less_func *less, void *aux)
+{
+  h->cur.slots = calloc (MIN_SLOT_CNT, sizeof *h->cur.slots);
+  h->cur.slot_cnt = MIN_SLOT_CNT;
+  h->cur.elem_cnt = 0;
+  h->old.slots = NULL;
+  h->old.slot_cnt = 0;
+  h->old.elem_cnt = 0;
+  h->migrate_idx = 0;
+  h->hash = hash;
+  h->less = less;
+  h->aux = aux;
+
+  return h->cur.slots != NULL;
+}
+
+/* Removes all the elements from H.
+
+   If DESTRUCTOR is non-null, then it is called for each element
+   in the hash.  DESTRUCTOR may, if appropriate, deallocate the
+   memory used by the hash element.  However, modifying hash
+   table H while ohash_clear() is running, using any of the
+   functions ohash_clear(), ohash_destroy(), ohash_insert(),
+   ohash_replace(), or ohash_delete(), yields undefined behavior,
+   whether done in DESTRUCTOR or elsewhere. */
+void
+ohash_clear (struct ohash *h, ohash_action_func *destructor)
+{
+  if (destructor != NULL)
+    ohash_apply (h, destructor);
+
+  memset (h->cur.slots, 0, sizeof *h->cur.slots * h->cur.slot_cnt);
+  h->cur.elem_cnt = 0;
+  free (h->old.slots);
+  h->old.slots = NULL;
+  h->old.slot_cnt = 0;
+  h->old.elem_cnt = 0;
+}
+
+/* Destroys hash table H.
+
+   If DESTRUCTOR is non-null, then it is first called for each
+   element in the hash.  DESTRUCTOR may, if appropriate,
+   deallocate the memory used by the hash element.  However,
+   modifying hash table H while ohash_clear() is running, using
+   any of the functions ohash_clear(), ohash_destroy(),
+   ohash_insert(), ohash_replace(), or ohash_delete(), yields
+   undefined behavior, whether done in DESTRUCTOR or
+   elsewhere. */
+void
+ohash_destroy (struct ohash *h, ohash_action_func *destructor)
+{
+  ohash_clear (h, destructor);
+  free (h->cur.slots);
+}
+
+/* Inserts NEW into hash table H and returns a null pointer, if
+   no equal element is already in the table.
+   If an equal element is already in the table, returns it
+   without inserting NEW.
+
+   Panics if the table is full and cannot be enlarged. */
+struct ohash_elem *
+ohash_insert (struct ohash *h, struct ohash_elem *new)
+{
+  struct ohash_elem *old = ohash_find (h, new);
+
+  if (old == NULL)
+    {
+      struct ohash_slot slot;
+
+      grow (h);
+      slot.hash = new->hash = h->hash (new, h->aux);
+      slot.elem = new;
+      put_slot (&h->cur, slot);
+    }
+  migrate (h, MIGRATE_CNT);
+
+  return old;
+}
+
+/* Inserts NEW into hash table H, replacing any equal element
+   already in the table, which is returned.
+
+   Panics if the table is full and cannot be enlarged. */
+struct ohash_elem *
+ohash_replace (struct ohash *h, struct ohash_elem *new)
+{
+  unsigned hash = h->hash (new, h->aux);
+  struct ohash_table *t = &h->cur;
+  size_t idx = find_slot (h, t, hash, new);
+  struct ohash_elem *old = NULL;
+
+  if (idx == NOT_FOUND)
+    {
+      t = &h->old;
+      idx = find_slot (h, t, hash, new);
+    }
+
+  new->hash = hash;
+  if (idx != NOT_FOUND)
+    {
+      old = t->slots[idx].elem;
+      t->slots[idx].elem = new;
+    }
+  else
+    {
+      struct ohash_slot slot;
+
+      grow (h);
+      slot.hash = hash;
+      slot.elem = new;
+      put_slot (&h->cur, slot);
+    }
+  migrate (h, MIGRATE_CNT);
+
+  return old;
+}
+
+/* Finds and returns an element equal to E in hash table H, or a
+   null pointer if no equal element exists in the table. */
+struct ohash_elem *
+ohash_find (struct ohash *h, struct ohash_elem *e)
+{
+  unsigned hash = h->hash (e, h->aux);
+  size_t idx;
+
+  idx = find_slot (h, &h->cur, hash, e);
+  if (idx != NOT_FOUND)
+    return h->cur.slots[idx].elem;
+  idx = find_slot (h, &h->old, hash, e);
+  if (idx != NOT_FOUND)
+    return h->old.slots[idx].elem;
+  return NULL;
+}
+
+/* Finds, removes, and returns an element equal to E in hash
+   table H.  Returns a null pointer if no equal element existed
+   in the table.
+
+   If the elements of the hash table are dynamically allocated,
+   or own resources that are, then it is the caller's
+   responsibility to deallocate them. */
+struct ohash_elem *
+ohash_delete (struct ohash *h, struct ohash_elem *e)
+{
+  unsigned hash = h->hash (e, h->aux);
+  struct ohash_table *t = &h->cur;
+  size_t idx = find_slot (h, t, hash, e);
+  struct ohash_elem *found = NULL;
+
+  if (idx == NOT_FOUND)
+    {
+      t = &h->old;
+      idx = find_slot (h, t, hash, e);
+    }
+  if (idx != NOT_FOUND)
+    {
+      found = t->slots[idx].elem;
+      remove_slot (t, idx);
+    }
+  migrate (h, MIGRATE_CNT);
+
+  return found;
+}
+
+/* Calls ACTION for each element in hash table H in arbitrary
+   order.
+   Modifying hash table H while ohash_apply() is running, using
+   any of the functions ohash_clear(), ohash_destroy(),
+   ohash_insert(), ohash_replace(), or ohash_delete(), yields
+   undefined behavior, whether done from ACTION or elsewhere. */
+void
+ohash_apply (struct ohash *h, ohash_action_func *action)
+{
+  struct ohash_iterator i;
+
+  ASSERT (action != NULL);
+
+  ohash_first (&i, h);
+  while (ohash_next (&i))
+    action (ohash_cur (&i), h->aux);
+}
+
+/* Initializes I for iterating hash table H.
+
+   Iteration idiom:
+
+      struct ohash_iterator i;
+
+      ohash_first (&i, h);
+      while (ohash_next (&i))
+        {
+          struct foo *f = ohash_entry (ohash_cur (&i), struct foo, elem);
+          ...do something with f...
+        }
+
+   Modifying hash table H during iteration, using any of the
+   functions ohash_clear(), ohash_destroy(), ohash_insert(),
+   ohash_replace(), or ohash_delete(), invalidates all
+   iterators. */
+void
+ohash_first (struct ohash_iterator *i, struct ohash *h)
+{
+  ASSERT (i != NULL);
+  ASSERT (h != NULL);
+
+  i->hash = h;
+  i->table = &h->cur;
+  i->idx = 0;
+  i->elem = NULL;
+}
+
+/* Advances I to the next element in the hash table and returns
+   it.  Returns a null pointer if no elements are left.  Elements
+   are returned in arbitrary order.
+
+   Modifying a hash table H during iteration, using any of the
+   functions ohash_clear(), ohash_destroy(), ohash_insert(),
+   ohash_replace(), or ohash_delete(), invalidates all
+   iterators. */
+struct ohash_elem *
+ohash_next (struct ohash_iterator *i)
+{
+  ASSERT (i != NULL);
+
+  i->elem = NULL;
+  while (i->elem == NULL)
+    if (i->idx < i->table->slot_cnt)
+      i->elem = i->table->slots[i->idx++].elem;
+    else if (i->table == &i->hash->cur)
+      {
+        i->table = &i->hash->old;
+        i->idx = 0;
+      }
+    else
+      break;
+
+  return i->elem;
+}
+
+/* Returns the current element in the hash table iteration, or a
+   null pointer at the end of the table.  Undefined behavior
+   after calling ohash_first() but before ohash_next(). */
+struct ohash_elem *
+ohash_cur (struct ohash_iterator *i)
+{
+  return i->elem;
+}
+
+/* Returns the number of elements in H. */
+size_t
+ohash_size (struct ohash *h)
+{
+  return h->cur.elem_cnt + h->old.elem_cnt;
+}
+
+/* Returns true if H contains no elements, false otherwise. */
+bool
+ohash_empty (struct ohash *h)
+{
+  return ohash_size (h) == 0;
+}
+
+/* Returns how far slot IDX in T is from the home slot of an
+   element with hash value HASH. */
+static inline size_t
+distance (const struct ohash_table *t, unsigned hash, size_t idx)
+{
+  return (idx - hash) & (t->slot_cnt - 1);
+}
+
+/* Returns the index of the slot in T that holds an element equal
+   to E, whose hash value is HASH, or NOT_FOUND if there is none.
+   Comparisons use H's comparison function. */
+static size_t
+find_slot (struct ohash *h, struct ohash_table *t, unsigned hash,
+           struct ohash_elem *e)
+{
+  size_t mask = t->slot_cnt - 1;
+  size_t idx, dist;
+
+  if (t->slots == NULL)
+    return NOT_FOUND;
+
+  /* Probe until an empty slot or one whose occupant is closer to
+     its home than E would be: Robin Hood insertion would have
+     put E there. */
+  for (idx = hash & mask, dist = 0; ; idx = (idx + 1) & mask, dist++)
+    {
+      struct ohash_slot *s = &t->slots[idx];
+
+      if (s->elem == NULL || distance (t, s->hash, idx) < dist)
+        return NOT_FOUND;
+      if (s->hash == hash
+          && !h->less (s->elem, e, h->aux) && !h->less (e, s->elem, h->aux))
+        return idx;
+    }
+}
+
+/* Inserts SLOT into T, which must have a free slot. */
+static void
+put_slot (struct ohash_table *t, struct ohash_slot slot)
+{
+  size_t mask = t->slot_cnt - 1;
+  size_t idx, dist;
+
+  ASSERT (t->elem_cnt < t->slot_cnt);
+
+  for (idx = slot.hash & mask, dist = 0; ; idx = (idx + 1) & mask, dist++)
+    {
+      struct ohash_slot *s = &t->slots[idx];
+      size_t s_dist;
+
+      if (s->elem == NULL)
+        {
+          *s = slot;
+          t->elem_cnt++;
+          return;
+        }
+
+      /* Take from the rich: an occupant nearer its home than SLOT
+         gives up its place and continues probing instead. */
+      s_dist = distance (t, s->hash, idx);
+      if (s_dist < dist)
+        {
+          struct ohash_slot tmp = *s;
+          *s = slot;
+          slot = tmp;
+          dist = s_dist;
+        }
+    }
+}
+
+/* Empties slot IDX in T, shifting the elements after it back by
+   one slot until one reaches its home or an empty slot is
+   found, so that searches never need to skip over holes. */
+static void
+remove_slot (struct ohash_table *t, size_t idx)
+{
+  size_t mask = t->slot_cnt - 1;
+
+  for (;;)
+    {
+      size_t next = (idx + 1) & mask;
+      struct ohash_slot *s = &t->slots[next];
+
+      if (s->elem == NULL || distance (t, s->hash, next) == 0)
+        break;
+      t->slots[idx] = *s;
+      idx = next;
+    }
+  t->slots[idx].elem = NULL;
+  t->elem_cnt--;
+}
+
+/* Moves elements from H's old table into its current table,
+   examining up to CNT slots of the old table, and frees the old
+   table once it is empty.
+
+   Slots are migrated in increasing order.  Every slot below
+   `migrate_idx' is empty, and removing an element only ever
+   shifts elements downward into a slot at or above it, so the
+   scan never misses an element. */
+static void
+migrate (struct ohash *h, size_t cnt)
+{
+  struct ohash_table *old = &h->old;
+
+  for (; old->slots != NULL && cnt > 0; cnt--)
+    {
+      ASSERT (h->migrate_idx < old->slot_cnt);
+      if (old->slots[h->migrate_idx].elem != NULL)
+        {
+          struct ohash_slot slot = old->slots[h->migrate_idx];
+          remove_slot (old, h->migrate_idx);
+          put_slot (&h->cur, slot);
+        }
+      else
+        h->migrate_idx++;
+
+      if (old->elem_cnt == 0)
+        {
+          free (old->slots);
+          old->slots = NULL;
+          old->slot_cnt = 0;
+        }
+    }
+}
+
+/* Makes room in H for one more element, starting a resize into
+   a table twice as big if the current table is 3/4 full.  If
+   there is no memory for a bigger table, H keeps using its
+   current one until it is completely full, then panics. */
+static void
+grow (struct ohash *h)
+{
+  struct ohash_slot *slots;
+  size_t slot_cnt;
+
+  if (ohash_size (h) < h->cur.slot_cnt / 4 * 3)
+    return;
+
+  /* Finish any resize still in progress.  At MIGRATE_CNT slots
+     per operation, it should be long done by now. */
+  migrate (h, SIZE_MAX);
+
+  slot_cnt = h->cur.slot_cnt * 2;
+  slots = calloc (slot_cnt, sizeof *slots);
+  if (slots != NULL)
+    {
+      h->old = h->cur;
+      h->migrate_idx = 0;
+      h->cur.slots = slots;
+      h->cur.slot_cnt = slot_cnt;
+      h->cur.elem_cnt = 0;
+    }
+  else if (h->cur.elem_cnt == h->cur.slot_cnt)
+    PANIC ("out of memory in hash table");
+}
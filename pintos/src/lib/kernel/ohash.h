@@ -0,0 +1,129 @@
+#ifndef __LIB_KERNEL_OHASH_H
+#define __LIB_KERNEL_OHASH_H
+
+/* Open-addressing hash table.
+
+   This is an alternative to the chained table in hash.h with the
+   same style of interface.  Each structure that can potentially
+   be in an ohash must embed a struct ohash_elem member, and the
+   ohash_entry macro converts a struct ohash_elem back to the
+   structure that contains it.  Unlike hash.h, the elements are
+   not linked to each other.  The table itself is a single array
+   of slots, each holding an element pointer and that element's
+   hash value, so a lookup usually touches one or two adjacent
+   cache lines.  The stored hash rejects almost every mismatched
+   slot without calling the comparison function.
+
+   Collisions are resolved by Robin Hood linear probing: an
+   insertion that finds a slot whose occupant is closer to its
+   home slot than the newcomer takes the slot and carries on
+   inserting the displaced element.  This keeps probe sequences
+   short and lets an unsuccessful search stop early.  Deletion
+   shifts the following elements back, so there are no
+   tombstones.
+
+   When the table gets too full, a table twice the size is
+   allocated, but the elements are not moved all at once.
+   Instead, each later insertion or deletion migrates a few of
+   them from the old table to the new one, and searches look in
+   both tables until the old one is empty.  No single operation
+   pays for re-inserting every element.
+
+   Costs, with N elements in the table: ohash_insert(),
+   ohash_replace(), ohash_find(), ohash_delete() are O(1)
+   expected.  ohash_find() never modifies the table.
+
+   Iterating with ohash_first() and ohash_next() is permitted
+   only while the table is not modified. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Hash table element. */
+struct ohash_elem
+  {
+    unsigned hash;              /* Hash value, set on insertion. */
+  };
+
+/* Converts pointer to hash element OHASH_ELEM into a pointer to
+   the structure that OHASH_ELEM is embedded inside.  Supply the
+   name of the outer structure STRUCT and the member name MEMBER
+   of the hash element. */
+#define ohash_entry(OHASH_ELEM, STRUCT, MEMBER)                 \
+        ((STRUCT *) ((uint8_t *) &(OHASH_ELEM)->hash            \
+                     - offsetof (STRUCT, MEMBER.hash)))
+
+/* Computes and returns the hash value for hash element E, given
+   auxiliary data AUX. */
+typedef unsigned ohash_hash_func (const struct ohash_elem *e, void *aux);
+
+/* Compares the value of two hash elements A and B, given
+   auxiliary data AUX.  Returns true if A is less than B, or
+   false if A is greater than or equal to B. */
+typedef bool ohash_less_func (const struct ohash_elem *a,
+                              const struct ohash_elem *b,
+                              void *aux);
+
+/* Performs some operation on hash element E, given auxiliary
+   data AUX. */
+typedef void ohash_action_func (struct ohash_elem *e, void *aux);
+
+/* A slot in a table. */
+struct ohash_slot
+  {
+    unsigned hash;              /* Hash value of `elem'. */
+    struct ohash_elem *elem;    /* Element, or null if empty. */
+  };
+
+/* An array of slots. */
+struct ohash_table
+  {
+    struct ohash_slot *slots;   /* Array of `slot_cnt' slots, or null. */
+    size_t slot_cnt;            /* Number of slots, a power of 2. */
+    size_t elem_cnt;            /* Number of elements in `slots'. */
+  };
+
+/* Hash table. */
+struct ohash
+  {
+    struct ohash_table cur;     /* Table that receives insertions. */
+    struct ohash_table old;     /* Table being migrated into `cur'. */
+    size_t migrate_idx;         /* Next slot in `old' to migrate. */
+    ohash_hash_func *hash;      /* Hash function. */
+    ohash_less_func *less;      /* Comparison function. */
+    void *aux;                  /* Auxiliary data for `hash' and `less'. */
+  };
+
+/* A hash table iterator. */
+struct ohash_iterator
+  {
+    struct ohash *hash;         /* The hash table. */
+    struct ohash_table *table;  /* Current table. */
+    size_t idx;                 /* Index of current slot in `table'. */
+    struct ohash_elem *elem;    /* Current hash element. */
+  };
+
+/* Basic life cycle. */
+bool ohash_init (struct ohash *, ohash_hash_func *, ohash_less_func *,
+                 void *aux);
+void ohash_clear (struct ohash *, ohash_action_func *);
+void ohash_destroy (struct ohash *, ohash_action_func *);
+
+/* Search, insertion, deletion. */
+struct ohash_elem *ohash_insert (struct ohash *, struct ohash_elem *);
+struct ohash_elem *ohash_replace (struct ohash *, struct ohash_elem *);
+struct ohash_elem *ohash_find (struct ohash *, struct ohash_elem *);
+struct ohash_elem *ohash_delete (struct ohash *, struct ohash_elem *);
+
+/* Iteration. */
+void ohash_apply (struct ohash *, ohash_action_func *);
+void ohash_first (struct ohash_iterator *, struct ohash *);
+struct ohash_elem *ohash_next (struct ohash_iterator *);
+struct ohash_elem *ohash_cur (struct ohash_iterator *);
+
+/* Information. */
+size_t ohash_size (struct ohash *);
+bool ohash_empty (struct ohash *);
+
+#endif /* lib/kernel/ohash.h */
@@ -0,0 +1,97 @@
+#ifndef __LIB_KERNEL_RBTREE_H
+#define __LIB_KERNEL_RBTREE_H
+
+/* Ordered set (red-black tree).
+
+   This is a binary search tree that keeps itself balanced by
+   coloring each element red or black, so that no path from the
+   root to a leaf is more than twice as long as any other.  Like
+   the linked list in list.h, it does not require use of
+   dynamically allocated memory.  Instead, each structure that
+   can potentially be in a tree must embed a struct rb_elem
+   member.  All of the tree functions operate on these `struct
+   rb_elem's.  The rb_entry macro allows conversion from a struct
+   rb_elem back to a structure object that contains it.
+
+   The tree is ordered by an rb_less_func supplied to rb_init().
+   Elements that compare equal are allowed, and are kept in the
+   order they were inserted, so a tree can stand in for a list
+   kept sorted with list_insert_ordered().
+
+   Costs, with N elements in the tree:
+
+     - rb_insert(), rb_remove(), rb_find(), rb_lower_bound(),
+       rb_upper_bound(), rb_min(), rb_max(): O(lg N).
+
+     - rb_next(), rb_prev(): O(1) amortized over an in-order
+       walk, O(lg N) worst case.
+
+   Iteration idiom:
+
+      struct rb_elem *e;
+
+      for (e = rb_min (&tree); e != NULL; e = rb_next (e))
+        {
+          struct foo *f = rb_entry (e, struct foo, elem);
+          ...do something with f...
+        }
+
+   If the value that an element is ordered by changes while the
+   element is in a tree, the element must be removed and
+   inserted again. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Tree element. */
+struct rb_elem
+  {
+    struct rb_elem *parent;     /* Parent, or null for the root. */
+    struct rb_elem *left;       /* Smaller elements. */
+    struct rb_elem *right;      /* Larger or equal elements. */
+    bool red;                   /* Red or black? */
+  };
+
+/* Converts pointer to tree element RB_ELEM into a pointer to the
+   structure that RB_ELEM is embedded inside.  Supply the name of
+   the outer structure STRUCT and the member name MEMBER of the
+   tree element. */
+#define rb_entry(RB_ELEM, STRUCT, MEMBER)               \
+        ((STRUCT *) ((uint8_t *) &(RB_ELEM)->parent     \
+                     - offsetof (STRUCT, MEMBER.parent)))
+
+/* Compares the value of two tree elements A and B, given
+   auxiliary data AUX.  Returns true if A is less than B, or
+   false if A is greater than or equal to B. */
+typedef bool rb_less_func (const struct rb_elem *a,
+                           const struct rb_elem *b,
+                           void *aux);
+
+/* Tree. */
+struct rb_tree
+  {
+    struct rb_elem *root;       /* Root, or null if empty. */
+    size_t size;                /* Number of elements. */
+    rb_less_func *less;         /* Comparison function. */
+    void *aux;                  /* Auxiliary data for `less'. */
+  };
+
+void rb_init (struct rb_tree *, rb_less_func *, void *aux);
+
+void rb_insert (struct rb_tree *, struct rb_elem *);
+struct rb_elem *rb_remove (struct rb_tree *, struct rb_elem *);
+
+struct rb_elem *rb_find (struct rb_tree *, const struct rb_elem *);
+struct rb_elem *rb_lower_bound (struct rb_tree *, const struct rb_elem *);
+struct rb_elem *rb_upper_bound (struct rb_tree *, const struct rb_elem *);
+
+struct rb_elem *rb_min (struct rb_tree *);
+struct rb_elem *rb_max (struct rb_tree *);
+struct rb_elem *rb_next (struct rb_elem *);
+struct rb_elem *rb_prev (struct rb_elem *);
+
+size_t rb_size (struct rb_tree *);
+bool rb_empty (struct rb_tree *);
+
+#endif /* lib/kernel/rbtree.h */
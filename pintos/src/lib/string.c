@@ -1,5 +1,103 @@
 #include <string.h>
 #include <debug.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* The block functions memcpy(), memmove(), and memset() work a
+   word at a time where they can.  Each first handles bytes one
+   at a time until the destination is word-aligned, then moves
+   whole words, then finishes off the last few bytes.  Blocks of
+   at least REP_THRESHOLD bytes are moved with the x86 string
+   instructions, which beat a loop of word moves once the block
+   is big enough to pay for their startup cost.  Blocks under
+   SMALL_THRESHOLD bytes are not worth aligning. */
+#define SMALL_THRESHOLD 16
+#define REP_THRESHOLD 256
+
+/* A word, for accessing memory that is also accessed through
+   other types. */
+typedef uint32_t __attribute__ ((may_alias)) word_t;
+#define WORD_SIZE sizeof (word_t)
+
+/* The same, but possibly misaligned, which x86 allows. */
+typedef uint32_t __attribute__ ((may_alias, aligned (1))) uword_t;
+
+/* The search and comparison functions also scan a word at a
+   time, using has_zero() to spot a null byte, or with a little
+   help a byte of any given value, in four bytes at once.  A
+   string's length is unknown until its terminator is found, so
+   reading a word that extends past the terminator must never
+   touch a page that the string does not.  An aligned word never
+   spans two pages; a misaligned read is only made when it does
+   not cross a PAGE_SIZE boundary either. */
+#define PAGE_SIZE 4096
+
+/* Returns nonzero if any byte in W is zero.  The carry out of a
+   byte only ever affects higher bytes, so the lowest zero byte
+   always has its high bit set in the result. */
+#define ONES 0x01010101u
+#define HIGHS 0x80808080u
+#define has_zero(W) (((W) - ONES) & ~(W) & HIGHS)
+
+/* Returns true if a word read at P would cross a page boundary. */
+static inline bool
+crosses_page (const void *p) 
+{
+  return (uintptr_t) p % PAGE_SIZE > PAGE_SIZE - WORD_SIZE;
+}
+
+/* Copies SIZE bytes from SRC to DST, from low addresses to high.
+   This is correct even if the blocks overlap, as long as DST is
+   below SRC, because each byte or word is read before any
+   write can reach it. */
+static void
+copy_forward (unsigned char *dst, const unsigned char *src, size_t size) 
+{
+  if (size >= SMALL_THRESHOLD)
+    {
+      for (; (uintptr_t) dst % WORD_SIZE != 0; size--)
+        *dst++ = *src++;
+      if (size >= REP_THRESHOLD)
+        {
+          size_t words = size / WORD_SIZE;
+          asm volatile ("rep movsl"
+                        : "+D" (dst), "+S" (src), "+c" (words) : : "memory");
+          size %= WORD_SIZE;
+        }
+      else
+        for (; size >= WORD_SIZE; size -= WORD_SIZE)
+          {
+            *(word_t *) dst = *(const word_t *) src;
+            dst += WORD_SIZE;
+            src += WORD_SIZE;
+          }
+    }
+  while (size-- > 0)
+    *dst++ = *src++;
+}
+
+/* Copies SIZE bytes from SRC to DST, from high addresses to low.
+   This is correct even if the blocks overlap with DST above
+   SRC. */
+static void
+copy_backward (unsigned char *dst, const unsigned char *src, size_t size) 
+{
+  dst += size;
+  src += size;
+  if (size >= SMALL_THRESHOLD)
+    {
+      for (; (uintptr_t) dst % WORD_SIZE != 0; size--)
+        *--dst = *--src;
+      for (; size >= WORD_SIZE; size -= WORD_SIZE)
+        {
+          dst -= WORD_SIZE;
+          src -= WORD_SIZE;
+          *(word_t *) dst = *(const word_t *) src;
+        }
+    }
+  while (size-- > 0)
+    *--dst = *--src;
+}
 
 /* Copies SIZE bytes from SRC to DST, which must not overlap.
    Returns DST. */
@@ -12,8 +110,7 @@ memcpy (void *dst_, const void *src_, size_t size)
   ASSERT (dst != NULL || size == 0);
   ASSERT (src != NULL || size == 0);
 
-  while (size-- > 0)
-    *dst++ = *src++;
+  copy_forward (dst, src, size);
 
   return dst_;
 }
@@ -30,19 +127,11 @@ memmove (void *dst_, const void *src_, size_t size)
   ASSERT (src != NULL || size == 0);
 
   if (dst < src) 
-    {
-      while (size-- > 0)
-        *dst++ = *src++;
-    }
-  else 
-    {
-      dst += size;
-      src += size;
-      while (size-- > 0)
-        *--dst = *--src;
-    }
+    copy_forward (dst, src, size);
+  else if (dst > src)
+    copy_backward (dst, src, size);
 
-  return dst;
+  return dst_;
 }
 
 /* Find the first differing byte in the two blocks of SIZE bytes
@@ -58,6 +147,19 @@ memcmp (const void *a_, const void *b_, size_t size)
   ASSERT (a != NULL || size == 0);
   ASSERT (b != NULL || size == 0);
 
+  if (size >= SMALL_THRESHOLD) 
+    {
+      /* Skip over equal words, then let the byte loop find the
+         difference, if any.  Only bytes inside the blocks are
+         read, so B need not be aligned. */
+      for (; (uintptr_t) a % WORD_SIZE != 0; a++, b++, size--)
+        if (*a != *b)
+          return *a > *b ? +1 : -1;
+      for (; size >= WORD_SIZE; a += WORD_SIZE, b += WORD_SIZE,
+             size -= WORD_SIZE)
+        if (*(const word_t *) a != *(const uword_t *) b)
+          break;
+    }
   for (; size-- > 0; a++, b++)
     if (*a != *b)
       return *a > *b ? +1 : -1;
@@ -78,6 +180,31 @@ strcmp (const char *a_, const char *b_)
   ASSERT (a != NULL);
   ASSERT (b != NULL);
 
+  /* Align A, then skip over equal words that contain no null
+     byte.  Where a word read from B would cross a page
+     boundary, the next four bytes are compared one at a time
+     instead, since B may end before the boundary. */
+  for (; (uintptr_t) a % WORD_SIZE != 0; a++, b++)
+    if (*a == '\0' || *a != *b)
+      return *a < *b ? -1 : *a > *b;
+  for (;;) 
+    if (crosses_page (b)) 
+      {
+        size_t i;
+
+        for (i = 0; i < WORD_SIZE; i++, a++, b++)
+          if (*a == '\0' || *a != *b)
+            return *a < *b ? -1 : *a > *b;
+      }
+    else 
+      {
+        word_t w = *(const word_t *) a;
+        if (w != *(const uword_t *) b || has_zero (w))
+          break;
+        a += WORD_SIZE;
+        b += WORD_SIZE;
+      }
+
   while (*a != '\0' && *a == *b) 
     {
       a++;
@@ -98,6 +225,18 @@ memchr (const void *block_, int ch_, size_t size)
 
   ASSERT (block != NULL || size == 0);
 
+  if (size >= SMALL_THRESHOLD) 
+    {
+      /* XORing with CH in every byte turns matches into zeros. */
+      word_t pattern = ch * ONES;
+
+      for (; (uintptr_t) block % WORD_SIZE != 0; block++, size--)
+        if (*block == ch)
+          return (void *) block;
+      for (; size >= WORD_SIZE; block += WORD_SIZE, size -= WORD_SIZE)
+        if (has_zero (*(const word_t *) block ^ pattern))
+          break;
+    }
   for (; size-- > 0; block++)
     if (*block == ch)
       return (void *) block;
@@ -113,9 +252,23 @@ char *
 strchr (const char *string, int c_) 
 {
   char c = c_;
+  word_t pattern = (unsigned char) c * ONES;
 
   ASSERT (string != NULL);
 
+  /* Skip over words that contain neither C nor a null byte. */
+  for (; (uintptr_t) string % WORD_SIZE != 0; string++)
+    if (*string == c)
+      return (char *) string;
+    else if (*string == '\0')
+      return NULL;
+  for (;; string += WORD_SIZE) 
+    {
+      word_t w = *(const word_t *) string;
+      if (has_zero (w) || has_zero (w ^ pattern))
+        break;
+    }
+
   for (;;) 
     if (*string == c)
       return (char *) string;
@@ -282,6 +435,26 @@ memset (void *dst_, int value, size_t size)
 
   ASSERT (dst != NULL || size == 0);
   
+  if (size >= SMALL_THRESHOLD)
+    {
+      word_t word = (unsigned char) value * 0x01010101u;
+
+      for (; (uintptr_t) dst % WORD_SIZE != 0; size--)
+        *dst++ = value;
+      if (size >= REP_THRESHOLD)
+        {
+          size_t words = size / WORD_SIZE;
+          asm volatile ("rep stosl"
+                        : "+D" (dst), "+c" (words) : "a" (word) : "memory");
+          size %= WORD_SIZE;
+        }
+      else
+        for (; size >= WORD_SIZE; size -= WORD_SIZE)
+          {
+            *(word_t *) dst = word;
+            dst += WORD_SIZE;
+          }
+    }
   while (size-- > 0)
     *dst++ = value;
 
@@ -296,7 +469,14 @@ strlen (const char *string)
 
   ASSERT (string != NULL);
 
-  for (p = string; *p != '\0'; p++)
+  /* Skip over words that contain no null byte. */
+  for (p = string; (uintptr_t) p % WORD_SIZE != 0; p++)
+    if (*p == '\0')
+      return p - string;
+  while (!has_zero (*(const word_t *) p))
+    p += WORD_SIZE;
+
+  for (; *p != '\0'; p++)
     continue;
   return p - string;
 }
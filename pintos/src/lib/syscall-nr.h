@@ -28,7 +28,22 @@ enum
     SYS_MKDIR,                  /* Create a directory. */
     SYS_READDIR,                /* Reads a directory entry. */
     SYS_ISDIR,                  /* Tests if a fd represents a directory. */
-    SYS_INUMBER                 /* Returns the inode number for a fd. */
+    SYS_INUMBER,                /* Returns the inode number for a fd. */
+
+    /* Extensions. */
+    SYS_WAIT_ANY,               /* Wait for any child process to die. */
+    SYS_NULL,                   /* Do nothing, to measure call overhead. */
+    SYS_IORING_SETUP,           /* Register a batched I/O ring. */
+    SYS_IORING_ENTER,           /* Run the requests queued in the ring. */
+    SYS_READV,                  /* Read from a file into several buffers. */
+    SYS_WRITEV,                 /* Write several buffers to a file. */
+    SYS_PREAD,                  /* Read from a file at a given offset. */
+    SYS_PWRITE,                 /* Write to a file at a given offset. */
+    SYS_PIPE,                   /* Create a pipe. */
+    SYS_EXEC_ASYNC,             /* Start a process without waiting. */
+    SYS_EXEC_STATUS,            /* Check whether a process has loaded. */
+    SYS_STATS,                  /* Read kernel statistics. */
+    SYS_DUP2                    /* Duplicate a file descriptor. */
   };
 
 #endif /* lib/syscall-nr.h */
@@ -1,3 +1,4 @@
+#include <cpu.h>
 #include <syscall.h>
 
 int main (int, char *[]);
@@ -6,5 +7,6 @@ void _start (int argc, char *argv[]);
 void
 _start (int argc, char *argv[]) 
 {
+  syscall_use_sysenter = cpu_has_sysenter ();
   exit (main (argc, argv));
 }
@@ -2,6 +2,7 @@
 #define __LIB_USER_SYSCALL_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <debug.h>
 
 /* Process identifier. */
@@ -19,6 +20,66 @@ typedef int mapid_t;
 #define EXIT_SUCCESS 0          /* Successful execution. */
 #define EXIT_FAILURE 1          /* Unsuccessful execution. */
 
+/* Buffer for readv() and writev(). */
+struct iovec
+  {
+    void *iov_base;             /* Start of buffer. */
+    size_t iov_len;             /* Number of bytes. */
+  };
+
+/* Maximum number of buffers passed to readv() or writev(). */
+#define IOV_MAX 1024
+
+/* Batched I/O ring, registered with ioring_setup().
+
+   A program queues a request by filling in sq[sq_tail %
+   IORING_ENTRIES] and incrementing sq_tail.  ioring_enter() then
+   runs every queued request in a single system call, advancing
+   sq_head past each one and appending its completion at
+   cq[cq_tail % IORING_ENTRIES], which increments cq_tail.  The
+   program consumes completions by advancing cq_head.  The kernel
+   stops early if the completion queue fills up.  All four
+   counters run freely and wrap around. */
+#define IORING_ENTRIES 32       /* Slots in each queue; a power of 2. */
+
+/* Request types. */
+enum ioring_op
+  {
+    IORING_NOP,                 /* Do nothing.  Result is 0. */
+    IORING_READ,                /* Like read(), or at `offset' if set. */
+    IORING_WRITE,               /* Like write(), or at `offset' if set. */
+    IORING_SEEK                 /* Like seek() to `offset'.  Result is 0. */
+  };
+
+/* Submission queue entry. */
+struct ioring_sqe
+  {
+    int op;                     /* An enum ioring_op. */
+    int fd;                     /* File descriptor. */
+    void *buffer;               /* Buffer to read into or write from. */
+    unsigned size;              /* Number of bytes to read or write. */
+    int offset;                 /* File offset, or -1 for the current one. */
+    unsigned data;              /* Copied into the completion. */
+  };
+
+/* Completion queue entry. */
+struct ioring_cqe
+  {
+    unsigned data;              /* `data' from the request. */
+    int result;                 /* Result as described above, or -1. */
+  };
+
+/* Submission and completion queues. */
+struct ioring
+  {
+    unsigned sq_head;           /* Next request the kernel will run. */
+    unsigned sq_tail;           /* Next free request slot. */
+    unsigned cq_head;           /* Next completion to consume. */
+    unsigned cq_tail;           /* Next free completion slot. */
+    struct ioring_sqe sq[IORING_ENTRIES];
+    struct ioring_cqe cq[IORING_ENTRIES];
+  };
+
 /* Projects 2 and later. */
 void halt (void) NO_RETURN;
 void exit (int status) NO_RETURN;
@@ -45,4 +106,22 @@ bool readdir (int fd, char name[READDIR_MAX_LEN + 1]);
 bool isdir (int fd);
 int inumber (int fd);
 
+/* Extensions. */
+pid_t wait_any (int *status);
+int null_syscall (void);
+bool ioring_setup (struct ioring *);
+int ioring_enter (void);
+int readv (int fd, const struct iovec *, int iovcnt);
+int writev (int fd, const struct iovec *, int iovcnt);
+int pread (int fd, void *buffer, unsigned length, unsigned offset);
+int pwrite (int fd, const void *buffer, unsigned length, unsigned offset);
+bool pipe (int fds[2]);
+pid_t exec_async (const char *file);
+int exec_status (pid_t, bool wait);
+int stats (char *buffer, unsigned size);
+int dup2 (int oldfd, int newfd);
+
+/* Enter the kernel with SYSENTER instead of `int $0x30'? */
+extern bool syscall_use_sysenter;
+
 #endif /* lib/user/syscall.h */
@@ -0,0 +1,153 @@
+#include "tests/bench/bench.h"
+#include <cpu.h>
+#include <debug.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef USERPROG
+#include "userprog/process.h"
+#endif
+
+struct bench
+  {
+    const char *name;
+    bench_func *function;
+  };
+
+static const struct bench benches[] =
+  {
+    {"thread-create", bench_thread_create},
+    {"context-switch", bench_context_switch},
+    {"lock", bench_lock},
+    {"lock-pingpong", bench_lock_pingpong},
+    {"malloc", bench_malloc},
+    {"palloc", bench_palloc},
+#ifdef USERPROG
+    {"null-syscall", bench_null_syscall},
+#endif
+#ifdef FILESYS
+    {"sector-read", bench_sector_read},
+    {"sector-write", bench_sector_write},
+    {"file-create", bench_file_create},
+    {"file-open", bench_file_open},
+    {"file-read", bench_file_read},
+#endif
+  };
+
+#define BENCH_CNT (sizeof benches / sizeof *benches)
+
+/* Runs the benchmark named NAME, or all of them if NAME is
+   "all". */
+void
+run_bench (const char *name)
+{
+  const struct bench *b;
+  bool all = !strcmp (name, "all");
+  bool found = false;
+
+  if (!(cpu_features () & CPU_TSC))
+    PANIC ("benchmarks need a CPU with a time-stamp counter");
+
+  for (b = benches; b < benches + BENCH_CNT; b++)
+    if (all || !strcmp (name, b->name))
+      {
+        b->function ();
+        found = true;
+      }
+  if (!found)
+    PANIC ("no benchmark named \"%s\"", name);
+}
+
+/* Times LOOP with auxiliary data AUX, running OPS operations per
+   repetition, and reports the result under NAME. */
+void
+bench_run (const char *name, bench_loop_func *loop, void *aux,
+           unsigned ops)
+{
+  uint64_t cycles[BENCH_REPS];
+  int i;
+
+  ASSERT (ops > 0);
+
+  for (i = 0; i < BENCH_WARMUP; i++)
+    loop (ops, aux);
+  for (i = 0; i < BENCH_REPS; i++)
+    {
+      uint64_t start = rdtsc ();
+      loop (ops, aux);
+      cycles[i] = rdtsc () - start;
+    }
+  bench_report (name, cycles, ops);
+}
+
+/* Sorts the BENCH_REPS elements of CYCLES into ascending order.
+   There are few enough that insertion sort is fine. */
+static void
+sort_cycles (uint64_t cycles[])
+{
+  int i, j;
+
+  for (i = 1; i < BENCH_REPS; i++)
+    {
+      uint64_t c = cycles[i];
+      for (j = i; j > 0 && cycles[j - 1] > c; j--)
+        cycles[j] = cycles[j - 1];
+      cycles[j] = c;
+    }
+}
+
+/* Reports BENCH_REPS timings in CYCLES, each for OPS operations,
+   under NAME.  Sorts CYCLES. */
+void
+bench_report (const char *name, uint64_t cycles[], unsigned ops)
+{
+  sort_cycles (cycles);
+  printf ("bench %s %"PRIu64" %"PRIu64" %"PRIu64"\n", name,
+          cycles[BENCH_REPS / 2] / ops, cycles[0] / ops,
+          cycles[BENCH_REPS - 1] / ops);
+}
+
+/* Reports that benchmark NAME could not run, because of WHY. */
+void
+bench_skip (const char *name, const char *why)
+{
+  printf ("bench %s skipped: %s\n", name, why);
+}
+
+/* Runs a struct bench_thread's function, then signals that it is
+   done. */
+static void
+bench_thread_func (void *bt_)
+{
+  struct bench_thread *bt = bt_;
+
+  bt->function (bt->aux);
+  sema_up (&bt->done);
+}
+
+/* Starts BT as a new thread with the running thread's priority,
+   named NAME, that runs FUNCTION with argument AUX. */
+void
+bench_thread_start (struct bench_thread *bt, const char *name,
+                    thread_func *function, void *aux)
+{
+  bt->function = function;
+  bt->aux = aux;
+  sema_init (&bt->done, 0);
+  bt->tid = thread_create (name, thread_get_priority (),
+                           bench_thread_func, bt);
+  if (bt->tid == TID_ERROR)
+    PANIC ("%s: thread_create failed", name);
+}
+
+/* Waits for BT's function to return. */
+void
+bench_thread_join (struct bench_thread *bt)
+{
+  sema_down (&bt->done);
+#ifdef USERPROG
+  /* Every thread is a child process here, so reap it too. */
+  process_wait (bt->tid);
+#endif
+}
@@ -0,0 +1,66 @@
+#ifndef TESTS_BENCH_BENCH_H
+#define TESTS_BENCH_BENCH_H
+
+/* Kernel microbenchmarks, run by the "bench" kernel action.
+
+   Each benchmark times a loop of some number of operations,
+   BENCH_WARMUP times to warm up caches without recording the
+   results, then BENCH_REPS times for real, and prints the
+   median, minimum, and maximum CPU cycles per operation over
+   the timed repetitions as a line of this form:
+
+     bench NAME MEDIAN MIN MAX
+
+   "make bench" collects these lines into a results file that can
+   be compared across commits. */
+
+#include <stdint.h>
+#include "threads/synch.h"
+#include "threads/thread.h"
+
+void run_bench (const char *name);
+
+/* Runs OPS operations, given auxiliary data AUX. */
+typedef void bench_loop_func (unsigned ops, void *aux);
+
+#define BENCH_WARMUP 2          /* Untimed repetitions. */
+#define BENCH_REPS 10           /* Timed repetitions. */
+
+void bench_run (const char *name, bench_loop_func *, void *aux,
+                unsigned ops);
+void bench_report (const char *name, uint64_t cycles[], unsigned ops);
+void bench_skip (const char *name, const char *why);
+
+/* A helper thread for a benchmark that needs more than one. */
+struct bench_thread
+  {
+    tid_t tid;                  /* Thread's tid. */
+    thread_func *function;      /* Function it runs. */
+    void *aux;                  /* Argument to `function'. */
+    struct semaphore done;      /* Upped when `function' returns. */
+  };
+
+void bench_thread_start (struct bench_thread *, const char *name,
+                         thread_func *, void *aux);
+void bench_thread_join (struct bench_thread *);
+
+typedef void bench_func (void);
+
+extern bench_func bench_thread_create;
+extern bench_func bench_context_switch;
+extern bench_func bench_lock;
+extern bench_func bench_lock_pingpong;
+extern bench_func bench_malloc;
+extern bench_func bench_palloc;
+#ifdef USERPROG
+extern bench_func bench_null_syscall;
+#endif
+#ifdef FILESYS
+extern bench_func bench_sector_read;
+extern bench_func bench_sector_write;
+extern bench_func bench_file_create;
+extern bench_func bench_file_open;
+extern bench_func bench_file_read;
+#endif
+
+#endif /* tests/bench/bench.h */
@@ -0,0 +1,191 @@
+/* Disk and file system benchmarks:
+
+   - sector-read: reading a sector from the file system device.
+
+   - sector-write: writing a sector to the scratch device, which
+     is skipped if there is none, since writing anywhere else
+     would damage the file system.
+
+   - file-create: creating and removing an empty file.
+
+   - file-open: opening and closing a file.
+
+   - file-read: reading a sector's worth of data from a file. */
+
+#include "tests/bench/bench.h"
+#include <debug.h>
+#include <stdio.h>
+#include "devices/block.h"
+#include "filesys/file.h"
+#include "filesys/filesys.h"
+#include "threads/palloc.h"
+
+/* Number of sectors that sector-read and sector-write cycle
+   through. */
+#define BENCH_SECTORS 8
+
+/* Name of the file that file-open and file-read use. */
+#define BENCH_FILE "bench-file"
+
+/* Number of sectors in BENCH_FILE. */
+#define BENCH_FILE_SECTORS 8
+
+/* Reads or writes successive sectors of a block device, starting
+   over after BENCH_SECTORS of them. */
+struct sector_io
+  {
+    struct block *block;
+    void *buffer;
+    bool write;
+  };
+
+static void
+sector_loop (unsigned ops, void *io_)
+{
+  struct sector_io *io = io_;
+  unsigned i;
+
+  for (i = 0; i < ops; i++)
+    {
+      block_sector_t sector = i % BENCH_SECTORS;
+      if (io->write)
+        block_write (io->block, sector, io->buffer);
+      else
+        block_read (io->block, sector, io->buffer);
+    }
+}
+
+/* Runs a sector benchmark named NAME on the device with ROLE. */
+static void
+bench_sectors (const char *name, enum block_type role, bool write)
+{
+  struct sector_io io;
+
+  io.block = block_get_role (role);
+  if (io.block == NULL || block_size (io.block) < BENCH_SECTORS)
+    {
+      bench_skip (name, "no suitable device");
+      return;
+    }
+  io.buffer = palloc_get_page (PAL_ASSERT | PAL_ZERO);
+  io.write = write;
+  bench_run (name, sector_loop, &io, 100);
+  palloc_free_page (io.buffer);
+}
+
+void
+bench_sector_read (void)
+{
+  bench_sectors ("sector-read", BLOCK_FILESYS, false);
+}
+
+void
+bench_sector_write (void)
+{
+  bench_sectors ("sector-write", BLOCK_SCRATCH, true);
+}
+
+static void
+create_loop (unsigned ops, void *aux UNUSED)
+{
+  unsigned i;
+
+  for (i = 0; i < ops; i++)
+    {
+      char name[24];
+      snprintf (name, sizeof name, "bench-%u", i);
+      if (!filesys_create (name, 0) || !filesys_remove (name))
+        PANIC ("%s: create or remove failed", name);
+    }
+}
+
+void
+bench_file_create (void)
+{
+  bench_run ("file-create", create_loop, NULL, 20);
+}
+
+/* Creates BENCH_FILE with BENCH_FILE_SECTORS sectors of data and
+   returns it opened. */
+static struct file *
+open_bench_file (void)
+{
+  off_t size = BENCH_FILE_SECTORS * BLOCK_SECTOR_SIZE;
+  void *buffer = palloc_get_page (PAL_ASSERT | PAL_ZERO);
+  struct file *file;
+
+  if (!filesys_create (BENCH_FILE, size)
+      || (file = filesys_open (BENCH_FILE)) == NULL)
+    PANIC ("%s: create or open failed", BENCH_FILE);
+  if (file_write (file, buffer, size) != size)
+    PANIC ("%s: write failed", BENCH_FILE);
+  palloc_free_page (buffer);
+  return file;
+}
+
+/* Closes FILE and removes BENCH_FILE. */
+static void
+close_bench_file (struct file *file)
+{
+  file_close (file);
+  if (!filesys_remove (BENCH_FILE))
+    PANIC ("%s: remove failed", BENCH_FILE);
+}
+
+static void
+open_loop (unsigned ops, void *aux UNUSED)
+{
+  unsigned i;
+
+  for (i = 0; i < ops; i++)
+    {
+      struct file *file = filesys_open (BENCH_FILE);
+      if (file == NULL)
+        PANIC ("%s: open failed", BENCH_FILE);
+      file_close (file);
+    }
+}
+
+void
+bench_file_open (void)
+{
+  struct file *file = open_bench_file ();
+
+  bench_run ("file-open", open_loop, NULL, 100);
+  close_bench_file (file);
+}
+
+/* Reads successive sectors of data from a file, starting over
+   after BENCH_FILE_SECTORS of them. */
+struct file_io
+  {
+    struct file *file;
+    void *buffer;
+  };
+
+static void
+read_loop (unsigned ops, void *io_)
+{
+  struct file_io *io = io_;
+  unsigned i;
+
+  for (i = 0; i < ops; i++)
+    {
+      off_t ofs = i % BENCH_FILE_SECTORS * BLOCK_SECTOR_SIZE;
+      if (file_read_at (io->file, io->buffer, BLOCK_SECTOR_SIZE, ofs)
+          != BLOCK_SECTOR_SIZE)
+        PANIC ("%s: read failed", BENCH_FILE);
+    }
+}
+
+void
+bench_file_read (void)
+{
+  struct file_io io;
+
+  io.file = open_bench_file ();
+  io.buffer = palloc_get_page (PAL_ASSERT);
+  bench_run ("file-read", read_loop, &io, 100);
+  palloc_free_page (io.buffer);
+  close_bench_file (io.file);
+}
@@ -0,0 +1,45 @@
+/* Memory allocator benchmarks:
+
+   - malloc: allocating and freeing a 64-byte block.
+
+   - palloc: allocating and freeing a page. */
+
+#include "tests/bench/bench.h"
+#include <debug.h>
+#include "threads/malloc.h"
+#include "threads/palloc.h"
+
+static void
+malloc_loop (unsigned ops, void *aux UNUSED)
+{
+  unsigned i;
+
+  for (i = 0; i < ops; i++)
+    {
+      void *p = malloc (64);
+      if (p == NULL)
+        PANIC ("malloc failed");
+      free (p);
+    }
+}
+
+void
+bench_malloc (void)
+{
+  bench_run ("malloc", malloc_loop, NULL, 10000);
+}
+
+static void
+palloc_loop (unsigned ops, void *aux UNUSED)
+{
+  unsigned i;
+
+  for (i = 0; i < ops; i++)
+    palloc_free_page (palloc_get_page (PAL_ASSERT));
+}
+
+void
+bench_palloc (void)
+{
+  bench_run ("palloc", palloc_loop, NULL, 1000);
+}
@@ -0,0 +1,52 @@
+/* User half of the null-syscall kernel benchmark.  Times null
+   system calls made with `int $0x30' and, if the CPU supports it,
+   with SYSENTER, the same way as bench_run() in the kernel, and
+   prints the results in the same form. */
+
+#include <cpu.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <syscall.h>
+
+#define WARMUP 2                /* Untimed repetitions. */
+#define REPS 10                 /* Timed repetitions. */
+#define OPS 10000               /* Calls per repetition. */
+
+/* Times REPS repetitions of OPS null system calls, made with
+   SYSENTER if FAST is true, and reports them under NAME. */
+static void
+measure (const char *name, bool fast)
+{
+  uint64_t cycles[REPS];
+  int i, j;
+
+  syscall_use_sysenter = fast;
+  for (i = 0; i < WARMUP + REPS; i++)
+    {
+      uint64_t start = rdtsc ();
+      for (j = 0; j < OPS; j++)
+        null_syscall ();
+      if (i >= WARMUP)
+        cycles[i - WARMUP] = rdtsc () - start;
+    }
+  syscall_use_sysenter = false;
+
+  for (i = 1; i < REPS; i++)
+    {
+      uint64_t c = cycles[i];
+      for (j = i; j > 0 && cycles[j - 1] > c; j--)
+        cycles[j] = cycles[j - 1];
+      cycles[j] = c;
+    }
+  printf ("bench %s %"PRIu64" %"PRIu64" %"PRIu64"\n", name,
+          cycles[REPS / 2] / OPS, cycles[0] / OPS, cycles[REPS - 1] / OPS);
+}
+
+int
+main (void)
+{
+  measure ("null-syscall", false);
+  if (cpu_has_sysenter ())
+    measure ("null-syscall-sysenter", true);
+  return 0;
+}
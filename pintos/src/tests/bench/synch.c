@@ -0,0 +1,86 @@
+/* Lock benchmarks:
+
+   - lock: acquiring and releasing a lock that no other thread
+     wants.
+
+   - lock-pingpong: acquiring a lock, yielding to a thread that
+     then blocks on it, and releasing it, which hands the lock to
+     that thread and makes the next acquisition wait in turn. */
+
+#include "tests/bench/bench.h"
+#include <debug.h>
+#include <stdbool.h>
+#include "threads/synch.h"
+#include "threads/thread.h"
+
+static void
+lock_loop (unsigned ops, void *lock_)
+{
+  struct lock *lock = lock_;
+  unsigned i;
+
+  for (i = 0; i < ops; i++)
+    {
+      lock_acquire (lock);
+      lock_release (lock);
+    }
+}
+
+void
+bench_lock (void)
+{
+  struct lock lock;
+
+  lock_init (&lock);
+  bench_run ("lock", lock_loop, &lock, 10000);
+}
+
+/* Shared by the two lock-pingpong threads. */
+struct pingpong
+  {
+    struct lock lock;
+    volatile bool stop;
+  };
+
+/* Acquires LOCK, yields while holding it, and releases it. */
+static void
+pingpong_once (struct lock *lock)
+{
+  lock_acquire (lock);
+  thread_yield ();
+  lock_release (lock);
+}
+
+/* Plays the other side of lock-pingpong until told to stop. */
+static void
+pingpong_partner (void *pp_)
+{
+  struct pingpong *pp = pp_;
+
+  while (!pp->stop)
+    pingpong_once (&pp->lock);
+}
+
+static void
+pingpong_loop (unsigned ops, void *pp_)
+{
+  struct pingpong *pp = pp_;
+  unsigned i;
+
+  for (i = 0; i < ops; i++)
+    pingpong_once (&pp->lock);
+}
+
+void
+bench_lock_pingpong (void)
+{
+  struct bench_thread bt;
+  struct pingpong pp;
+
+  lock_init (&pp.lock);
+  pp.stop = false;
+  bench_thread_start (&bt, "pingpong", pingpong_partner, &pp);
+  bench_run ("lock-pingpong", pingpong_loop, &pp, 1000);
+  pp.stop = true;
+  bench_thread_join (&bt);
+}
@@ -0,0 +1,25 @@
+/* System call benchmark:
+
+   - null-syscall: a system call that does nothing, made from the
+     user program tests/bench/null-syscall, which must be in the
+     file system and reports its own results. */
+
+#include "tests/bench/bench.h"
+#include "filesys/file.h"
+#include "filesys/filesys.h"
+#include "userprog/process.h"
+
+void
+bench_null_syscall (void)
+{
+  struct file *file = filesys_open ("null-syscall");
+
+  if (file == NULL)
+    {
+      bench_skip ("null-syscall", "program not in file system");
+      return;
+    }
+  file_close (file);
+
+  process_wait (process_execute ("null-syscall"));
+}
@@ -0,0 +1,70 @@
+/* Thread benchmarks:
+
+   - thread-create: creating a thread that exits at once, and
+     waiting for it to finish.
+
+   - context-switch: one switch between two threads that take
+     turns calling thread_yield(). */
+
+#include "tests/bench/bench.h"
+#include <debug.h>
+#include <stdbool.h>
+#include "threads/thread.h"
+
+/* Does nothing. */
+static void
+do_nothing (void *aux UNUSED)
+{
+}
+
+static void
+create_loop (unsigned ops, void *aux UNUSED)
+{
+  struct bench_thread bt;
+  unsigned i;
+
+  for (i = 0; i < ops; i++)
+    {
+      bench_thread_start (&bt, "bench", do_nothing, NULL);
+      bench_thread_join (&bt);
+    }
+}
+
+void
+bench_thread_create (void)
+{
+  bench_run ("thread-create", create_loop, NULL, 50);
+}
+
+/* Yields until *STOP becomes true. */
+static void
+yield_until (void *stop_)
+{
+  volatile bool *stop = stop_;
+
+  while (!*stop)
+    thread_yield ();
+}
+
+/* Each yield switches to the other thread, which yields back, so
+   it takes two switches. */
+static void
+switch_loop (unsigned ops, void *aux UNUSED)
+{
+  unsigned i;
+
+  for (i = 0; i < ops; i += 2)
+    thread_yield ();
+}
+
+void
+bench_context_switch (void)
+{
+  struct bench_thread bt;
+  bool stop = false;
+
+  bench_thread_start (&bt, "yielder", yield_until, &stop);
+  bench_run ("context-switch", switch_loop, NULL, 1000);
+  stop = true;
+  bench_thread_join (&bt);
+}
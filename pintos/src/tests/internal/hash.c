@@ -0,0 +1,169 @@
+/* Test program for the hash functions in lib/kernel/hash.c.
+
+   Compares hash_bytes(), hash_string(), and hash_int() against
+   the byte-at-a-time Fowler-Noll-Vo hash that they replaced.
+   For distribution, hashes sequential integers, which is what
+   tids and sector numbers look like, and short generated names
+   into power-of-2 bucket arrays, and reports the worst bucket
+   and the chi-squared statistic for each.  For speed, reports
+   cycles per hash for keys from 4 to 1024 bytes.
+
+   This is not a test we will run on your submitted projects.
+   It is here for completeness.
+*/
+
+#undef NDEBUG
+#include <cpu.h>
+#include <debug.h>
+#include <hash.h>
+#include <inttypes.h>
+#include <random.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/test.h"
+
+/* Number of buckets; keys hashed per distribution test. */
+#define BUCKET_CNT 1024
+#define KEY_CNT (BUCKET_CNT * 8)
+
+/* Number of times each key size is timed. */
+#define REPEAT_CNT 64
+
+static unsigned bucket_cnts[BUCKET_CNT];
+
+static void distribution (void);
+static void speed (void);
+
+/* Test hash function implementations. */
+void
+test (void) 
+{
+  /* Sanity checks. */
+  ASSERT (hash_string ("pintos") == hash_bytes ("pintos", 6));
+  ASSERT (hash_string ("pintos") != hash_string ("pintoS"));
+  ASSERT (hash_bytes ("abcde", 5) != hash_bytes ("abcdf", 5));
+  ASSERT (hash_bytes ("", 0) != hash_bytes ("\0", 1));
+  ASSERT (hash_int (1) != hash_int (2));
+  ASSERT (hash_ptr (&bucket_cnts[0]) != hash_ptr (&bucket_cnts[1]));
+
+  distribution ();
+  speed ();
+  printf ("hash: PASS\n");
+}
+
+/* Fowler-Noll-Vo 32-bit hash, for bytes. */
+static unsigned
+fnv_bytes (const void *buf_, size_t size) 
+{
+  const unsigned char *buf = buf_;
+  unsigned hash = 2166136261u;
+
+  while (size-- > 0)
+    hash = (hash * 16777619u) ^ *buf++;
+  return hash;
+}
+
+/* The old hash_int(). */
+static unsigned
+fnv_int (int i) 
+{
+  return fnv_bytes (&i, sizeof i);
+}
+
+/* Returns the I'th generated name, "file0", "file1", .... */
+static const char *
+name (int i) 
+{
+  static char buf[16];
+
+  snprintf (buf, sizeof buf, "file%d", i);
+  return buf;
+}
+
+/* Hashes KEY_CNT keys into BUCKET_CNT buckets with hash function
+   HASH applied to the keys generated by KEY, and prints the
+   largest bucket and the chi-squared statistic, in hundredths,
+   under the heading LABEL.  For a uniform hash, the statistic
+   should come out near BUCKET_CNT - 1. */
+static void
+report (const char *label, unsigned (*hash) (int i)) 
+{
+  const unsigned expected = KEY_CNT / BUCKET_CNT;
+  unsigned max = 0;
+  uint64_t chi2 = 0;
+  int i;
+
+  memset (bucket_cnts, 0, sizeof bucket_cnts);
+  for (i = 0; i < KEY_CNT; i++)
+    bucket_cnts[hash (i) % BUCKET_CNT]++;
+
+  for (i = 0; i < BUCKET_CNT; i++) 
+    {
+      int diff = (int) bucket_cnts[i] - (int) expected;
+      chi2 += (uint64_t) (diff * diff) * 100 / expected;
+      if (bucket_cnts[i] > max)
+        max = bucket_cnts[i];
+    }
+  printf ("%-16s max bucket %3u (mean %u), chi-squared %6"PRIu64".%02"PRIu64"\n",
+          label, max, expected, chi2 / 100, chi2 % 100);
+}
+
+static unsigned new_int (int i) { return hash_int (i); }
+static unsigned old_int (int i) { return fnv_int (i); }
+static unsigned new_stride (int i) { return hash_int (i * 4096); }
+static unsigned old_stride (int i) { return fnv_int (i * 4096); }
+static unsigned new_name (int i) { return hash_string (name (i)); }
+static unsigned old_name (int i) 
+{
+  const char *s = name (i);
+  return fnv_bytes (s, strlen (s));
+}
+
+/* Reports how evenly each hash spreads typical keys. */
+static void
+distribution (void) 
+{
+  report ("hash_int 0...", new_int);
+  report ("fnv_int 0...", old_int);
+  report ("hash_int 4k*i", new_stride);
+  report ("fnv_int 4k*i", old_stride);
+  report ("hash_string", new_name);
+  report ("fnv string", old_name);
+}
+
+/* Reports cycles per hash for keys of various sizes. */
+static void
+speed (void) 
+{
+  static uint8_t key[1024];
+  volatile unsigned sink;
+  size_t size;
+
+  if (!(cpu_features () & CPU_TSC)) 
+    {
+      printf ("no time-stamp counter, skipping speed test\n");
+      return;
+    }
+
+  random_bytes (key, sizeof key);
+  printf ("cycles/hash   hash_bytes      fnv\n");
+  for (size = 4; size <= sizeof key; size *= 2) 
+    {
+      uint64_t start, new_cycles, old_cycles;
+      int i;
+
+      start = rdtsc ();
+      for (i = 0; i < REPEAT_CNT; i++)
+        sink = hash_bytes (key, size);
+      new_cycles = rdtsc () - start;
+
+      start = rdtsc ();
+      for (i = 0; i < REPEAT_CNT; i++)
+        sink = fnv_bytes (key, size);
+      old_cycles = rdtsc () - start;
+
+      printf ("%4zu bytes %11"PRIu64" %8"PRIu64"\n",
+              size, new_cycles / REPEAT_CNT, old_cycles / REPEAT_CNT);
+    }
+  (void) sink;
+}
@@ -0,0 +1,136 @@
+/* Test program for lib/kernel/heap.c.
+
+   Fills heaps of various sizes with values in random order,
+   with duplicates, removes and reorders random elements, and
+   checks that popping returns the rest in descending order with
+   equal values in insertion order.
+
+   This is not a test we will run on your submitted projects.
+   It is here for completeness.
+*/
+
+#undef NDEBUG
+#include <debug.h>
+#include <heap.h>
+#include <random.h>
+#include <stdio.h>
+#include "threads/test.h"
+
+/* Maximum number of elements in a heap that we will test. */
+#define MAX_SIZE 256
+
+/* A heap element. */
+struct value 
+  {
+    struct heap_elem elem;      /* Heap element. */
+    int value;                  /* Item value. */
+    int seq;                    /* Insertion order. */
+    bool in_heap;               /* Still in the heap? */
+  };
+
+static void shuffle (struct value *[], size_t);
+static bool value_less (const struct heap_elem *, const struct heap_elem *,
+                        void *);
+
+/* Test the heap implementation. */
+void
+test (void) 
+{
+  int size;
+
+  printf ("testing various size heaps:");
+  for (size = 0; size < MAX_SIZE; size = size * 5 / 4 + 1) 
+    {
+      int repeat;
+
+      printf (" %d", size);
+      for (repeat = 0; repeat < 10; repeat++) 
+        {
+          static struct value values[MAX_SIZE];
+          static struct value *order[MAX_SIZE];
+          struct heap heap;
+          struct value *prev;
+          int i, left;
+
+          /* Insert values 0...SIZE/2, each twice, in random
+             order. */
+          heap_init (&heap, value_less, NULL);
+          for (i = 0; i < size; i++) 
+            {
+              values[i].value = i / 2;
+              order[i] = &values[i];
+            }
+          shuffle (order, size);
+          for (i = 0; i < size; i++) 
+            {
+              order[i]->seq = i;
+              order[i]->in_heap = true;
+              heap_insert (&heap, &order[i]->elem);
+            }
+          ASSERT (heap_size (&heap) == (size_t) size);
+
+          /* Remove a quarter of the elements and give another
+             quarter new values.  Updated elements keep their
+             places among equal elements. */
+          shuffle (order, size);
+          for (i = 0; i < size / 4; i++) 
+            {
+              ASSERT (heap_remove (&heap, &order[i]->elem) == &order[i]->elem);
+              order[i]->in_heap = false;
+            }
+          for (; i < size / 2; i++) 
+            {
+              order[i]->value = random_ulong () % (size + 1);
+              heap_update (&heap, &order[i]->elem);
+            }
+          left = size - size / 4;
+          ASSERT (heap_size (&heap) == (size_t) left);
+
+          /* Pop everything, verifying the order. */
+          prev = NULL;
+          while (!heap_empty (&heap)) 
+            {
+              struct value *v = heap_entry (heap_front (&heap),
+                                            struct value, elem);
+              ASSERT (heap_pop_front (&heap) == &v->elem);
+              ASSERT (v->in_heap);
+              ASSERT (prev == NULL || prev->value > v->value
+                      || (prev->value == v->value && prev->seq < v->seq));
+              v->in_heap = false;
+              prev = v;
+              left--;
+            }
+          ASSERT (left == 0);
+        }
+    }
+  
+  printf (" done\n");
+  printf ("heap: PASS\n");
+}
+
+/* Shuffles the CNT elements in ARRAY into random order. */
+static void
+shuffle (struct value **array, size_t cnt) 
+{
+  size_t i;
+
+  for (i = 0; i < cnt; i++)
+    {
+      size_t j = i + random_ulong () % (cnt - i);
+      struct value *t = array[j];
+      array[j] = array[i];
+      array[i] = t;
+    }
+}
+
+/* Returns true if value A is less than value B, false
+   otherwise. */
+static bool
+value_less (const struct heap_elem *a_, const struct heap_elem *b_,
+            void *aux UNUSED) 
+{
+  const struct value *a = heap_entry (a_, struct value, elem);
+  const struct value *b = heap_entry (b_, struct value, elem);
+  
+  return a->value < b->value;
+}
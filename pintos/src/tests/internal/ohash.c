@@ -0,0 +1,316 @@
+/* Test program for lib/kernel/ohash.c.
+
+   Runs long random sequences of insertions, replacements,
+   deletions, and searches against a reference array that records
+   which element, if any, the table should hold for each key.
+   The sequences grow the table through several resizes, so many
+   of the operations, deletions included, land while elements are
+   still being migrated from the old table to the new one.  After
+   every operation, checks every key against the reference, the
+   Robin Hood ordering and migration invariants of both tables,
+   and that iterating with ohash_next() visits each element in
+   either table exactly once.
+
+   Each sequence is run with three hash functions: one that
+   spreads keys well, one that gives runs of keys the same hash,
+   and one that piles keys onto the last slots of the table so
+   that clusters wrap around to the first slots.
+
+   This is not a test we will run on your submitted projects.
+   It is here for completeness.
+*/
+
+#undef NDEBUG
+#include <debug.h>
+#include <ohash.h>
+#include <random.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/test.h"
+
+/* Number of distinct keys. */
+#define KEY_CNT 128
+
+/* Number of random operations per sequence. */
+#define OP_CNT 2000
+
+/* A hash table element.  There are two for each key, so that
+   ohash_replace() has something to replace with. */
+struct value
+  {
+    struct ohash_elem elem;     /* Hash table element. */
+    int key;                    /* Key. */
+  };
+
+/* Hash functions, selected by the auxiliary data. */
+enum hash_kind
+  {
+    HASH_SPREAD,                /* Keys spread over the table. */
+    HASH_RUNS,                  /* Runs of 8 keys hash the same. */
+    HASH_WRAP,                  /* Keys pile up at the table's end. */
+    HASH_KIND_CNT
+  };
+
+static const char *hash_names[HASH_KIND_CNT] = {"spread", "runs", "wrap"};
+
+static struct value values[2][KEY_CNT];
+static struct value *expected[KEY_CNT];
+static bool seen[KEY_CNT];
+
+/* Counts of interesting events in the current sequence. */
+static int migrating_inserts;   /* Insertions during a resize. */
+static int migrating_deletes;   /* Deletions during a resize. */
+static int wrapped_slots;       /* Wrapped elements seen by verify(). */
+
+static void run_sequence (enum hash_kind);
+static unsigned value_hash (const struct ohash_elem *, void *);
+static bool value_less (const struct ohash_elem *, const struct ohash_elem *,
+                        void *);
+static void verify (struct ohash *, size_t size);
+
+/* Test the open-addressing hash table implementation. */
+void
+test (void)
+{
+  enum hash_kind kind;
+
+  for (kind = 0; kind < HASH_KIND_CNT; kind++)
+    run_sequence (kind);
+  printf ("ohash: PASS\n");
+}
+
+/* Runs a random sequence of operations on a table that uses hash
+   function KIND, checking it against the reference after every
+   operation, then empties the table. */
+static void
+run_sequence (enum hash_kind kind)
+{
+  struct ohash h;
+  struct value key;
+  size_t size = 0;
+  int op;
+
+  printf ("testing with %s hash:", hash_names[kind]);
+  migrating_inserts = migrating_deletes = wrapped_slots = 0;
+  memset (expected, 0, sizeof expected);
+  for (op = 0; op < KEY_CNT; op++)
+    values[0][op].key = values[1][op].key = op;
+
+  ASSERT (ohash_init (&h, value_hash, value_less, (void *) kind));
+  verify (&h, 0);
+
+  for (op = 0; op < OP_CNT; op++)
+    {
+      int k = random_ulong () % KEY_CNT;
+      struct value *v = &values[random_ulong () % 2][k];
+      bool migrating = h.old.slots != NULL;
+      struct ohash_elem *e;
+
+      /* The table grows, with deletions mixed in, for the first
+         half of the sequence, and shrinks for the second. */
+      switch (random_ulong () % 8 + (op < OP_CNT / 2 ? 0 : 4))
+        {
+        case 0:
+        case 1:
+        case 2:
+          /* Insert.  The other element for K may be present. */
+          if (expected[k] == v)
+            v = &values[v == &values[0][k]][k];
+          e = ohash_insert (&h, &v->elem);
+          ASSERT (e == (expected[k] != NULL ? &expected[k]->elem : NULL));
+          if (expected[k] == NULL)
+            {
+              expected[k] = v;
+              size++;
+            }
+          if (migrating)
+            migrating_inserts++;
+          break;
+
+        case 3:
+        case 4:
+          /* Replace. */
+          if (expected[k] == v)
+            v = &values[v == &values[0][k]][k];
+          e = ohash_replace (&h, &v->elem);
+          ASSERT (e == (expected[k] != NULL ? &expected[k]->elem : NULL));
+          if (expected[k] == NULL)
+            size++;
+          expected[k] = v;
+          if (migrating)
+            migrating_inserts++;
+          break;
+
+        case 5:
+          /* Search. */
+          key.key = k;
+          e = ohash_find (&h, &key.elem);
+          ASSERT (e == (expected[k] != NULL ? &expected[k]->elem : NULL));
+          break;
+
+        default:
+          /* Delete, by a key that is not the element itself. */
+          key.key = k;
+          e = ohash_delete (&h, &key.elem);
+          ASSERT (e == (expected[k] != NULL ? &expected[k]->elem : NULL));
+          if (expected[k] != NULL)
+            {
+              expected[k] = NULL;
+              size--;
+            }
+          if (migrating)
+            migrating_deletes++;
+          break;
+        }
+      verify (&h, size);
+    }
+
+  /* Empty the table. */
+  for (op = 0; op < KEY_CNT; op++)
+    if (expected[op] != NULL)
+      {
+        ASSERT (ohash_delete (&h, &expected[op]->elem)
+                == &expected[op]->elem);
+        expected[op] = NULL;
+        verify (&h, --size);
+      }
+  ASSERT (ohash_empty (&h));
+  ohash_destroy (&h, NULL);
+
+  printf (" %d inserts and %d deletes during resizes, %d wrapped\n",
+          migrating_inserts, migrating_deletes, wrapped_slots);
+  ASSERT (migrating_inserts > 0 && migrating_deletes > 0);
+  ASSERT (kind != HASH_WRAP || wrapped_slots > 0);
+}
+
+/* Returns the hash of value E, computed according to the
+   enum hash_kind in AUX. */
+static unsigned
+value_hash (const struct ohash_elem *e, void *aux)
+{
+  int key = ohash_entry (e, struct value, elem)->key;
+
+  switch ((enum hash_kind) aux)
+    {
+    case HASH_SPREAD:
+      return (unsigned) key * 2654435761u;
+    case HASH_RUNS:
+      return ((unsigned) key / 8) * 2654435761u;
+    case HASH_WRAP:
+      /* Homes in the last 4 slots of a table of any size, with
+         the high bits different so that the stored hashes
+         differ. */
+      return -1u - key % 4 - ((unsigned) key << 20);
+    default:
+      NOT_REACHED ();
+    }
+}
+
+/* Returns true if value A's key is less than value B's, false
+   otherwise. */
+static bool
+value_less (const struct ohash_elem *a_, const struct ohash_elem *b_,
+            void *aux UNUSED)
+{
+  const struct value *a = ohash_entry (a_, struct value, elem);
+  const struct value *b = ohash_entry (b_, struct value, elem);
+
+  return a->key < b->key;
+}
+
+/* Returns how far slot IDX in T is from the home slot of an
+   element with hash value HASH. */
+static size_t
+distance (const struct ohash_table *t, unsigned hash, size_t idx)
+{
+  return (idx - hash) & (t->slot_cnt - 1);
+}
+
+/* Verifies the slots of table T, all of which before FIRST must
+   be empty, and returns the number of elements whose probe
+   sequence wrapped around from the end of T to its start. */
+static int
+verify_table (const struct ohash_table *t, size_t first)
+{
+  size_t idx, cnt = 0;
+  int wrapped = 0;
+
+  if (t->slots == NULL)
+    {
+      ASSERT (t->elem_cnt == 0);
+      return 0;
+    }
+
+  for (idx = 0; idx < t->slot_cnt; idx++)
+    {
+      const struct ohash_slot *s = &t->slots[idx];
+      const struct ohash_slot *prev;
+      size_t dist;
+
+      if (s->elem == NULL)
+        continue;
+      ASSERT (idx >= first);
+      ASSERT (s->hash == s->elem->hash);
+      cnt++;
+
+      /* Robin Hood order: an element away from its home follows
+         an occupied slot whose element is at least as far from
+         its own home, less one. */
+      dist = distance (t, s->hash, idx);
+      prev = &t->slots[(idx - 1) & (t->slot_cnt - 1)];
+      if (dist > 0)
+        {
+          ASSERT (prev->elem != NULL);
+          ASSERT (distance (t, prev->hash, (idx - 1) & (t->slot_cnt - 1))
+                  + 1 >= dist);
+        }
+      if (dist > idx)
+        wrapped++;
+    }
+  ASSERT (cnt == t->elem_cnt);
+  return wrapped;
+}
+
+/* Verifies that H holds exactly the elements in `expected', SIZE
+   of them, that both of its tables are well formed, and that
+   iteration visits each element once. */
+static void
+verify (struct ohash *h, size_t size)
+{
+  struct ohash_iterator i;
+  struct value key;
+  size_t cnt;
+  int k;
+
+  ASSERT (ohash_size (h) == size);
+  ASSERT (ohash_empty (h) == (size == 0));
+
+  wrapped_slots += verify_table (&h->cur, 0);
+  if (h->old.slots != NULL)
+    {
+      ASSERT (h->old.slot_cnt * 2 == h->cur.slot_cnt);
+      ASSERT (h->migrate_idx < h->old.slot_cnt);
+      verify_table (&h->old, h->migrate_idx);
+    }
+
+  for (k = 0; k < KEY_CNT; k++)
+    {
+      key.key = k;
+      ASSERT (ohash_find (h, &key.elem)
+              == (expected[k] != NULL ? &expected[k]->elem : NULL));
+    }
+
+  memset (seen, 0, sizeof seen);
+  cnt = 0;
+  ohash_first (&i, h);
+  while (ohash_next (&i))
+    {
+      struct value *v = ohash_entry (ohash_cur (&i), struct value, elem);
+      ASSERT (expected[v->key] == v);
+      ASSERT (!seen[v->key]);
+      seen[v->key] = true;
+      cnt++;
+    }
+  ASSERT (ohash_cur (&i) == NULL);
+  ASSERT (cnt == size);
+}
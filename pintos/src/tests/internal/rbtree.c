@@ -0,0 +1,199 @@
+/* Test program for lib/kernel/rbtree.c.
+
+   Builds trees of various sizes from values inserted in random
+   order, with duplicates, and checks the red-black invariants,
+   the ordering, and the searches after every insertion and
+   removal.
+
+   This is not a test we will run on your submitted projects.
+   It is here for completeness.
+*/
+
+#undef NDEBUG
+#include <debug.h>
+#include <random.h>
+#include <rbtree.h>
+#include <stdio.h>
+#include "threads/test.h"
+
+/* Maximum number of elements in a tree that we will test. */
+#define MAX_SIZE 256
+
+/* A tree element. */
+struct value 
+  {
+    struct rb_elem elem;        /* Tree element. */
+    int value;                  /* Item value. */
+    int seq;                    /* Insertion order among equal values. */
+  };
+
+static void shuffle (struct value *[], size_t);
+static bool value_less (const struct rb_elem *, const struct rb_elem *,
+                        void *);
+static void verify_tree (struct rb_tree *, size_t size);
+
+/* Test the red-black tree implementation. */
+void
+test (void) 
+{
+  int size;
+
+  printf ("testing various size trees:");
+  for (size = 0; size < MAX_SIZE; size = size * 5 / 4 + 1) 
+    {
+      int repeat;
+
+      printf (" %d", size);
+      for (repeat = 0; repeat < 10; repeat++) 
+        {
+          static struct value values[MAX_SIZE];
+          static struct value *order[MAX_SIZE];
+          struct rb_tree tree;
+          struct value key;
+          int i;
+
+          /* Put values 0...SIZE/2, each twice, in VALUES, and
+             pointers to them in random order in ORDER. */
+          for (i = 0; i < size; i++) 
+            {
+              values[i].value = i / 2;
+              order[i] = &values[i];
+            }
+          shuffle (order, size);
+
+          /* Insert, numbering equal values in insertion order and
+             verifying as we go. */
+          rb_init (&tree, value_less, NULL);
+          for (i = 0; i < size; i++) 
+            {
+              int j;
+
+              order[i]->seq = 0;
+              for (j = 0; j < i; j++)
+                if (order[j]->value == order[i]->value)
+                  order[i]->seq = order[j]->seq + 1;
+              rb_insert (&tree, &order[i]->elem);
+              verify_tree (&tree, i + 1);
+            }
+
+          /* Searches. */
+          for (i = -1; i <= size / 2 + 1; i++) 
+            {
+              struct rb_elem *e;
+
+              key.value = i;
+              e = rb_find (&tree, &key.elem);
+              if (i >= 0 && i < (size + 1) / 2) 
+                {
+                  struct value *v = rb_entry (e, struct value, elem);
+                  ASSERT (v->value == i && v->seq == 0);
+                }
+              else 
+                {
+                  ASSERT (e == NULL);
+                }
+
+              e = rb_lower_bound (&tree, &key.elem);
+              ASSERT ((i < 0 ? 0 : i) < (size + 1) / 2
+                      ? rb_entry (e, struct value, elem)->value == (i < 0 ? 0 : i)
+                      : e == NULL);
+
+              e = rb_upper_bound (&tree, &key.elem);
+              ASSERT (i + 1 < (size + 1) / 2
+                      ? rb_entry (e, struct value, elem)->value == i + 1
+                      : e == NULL);
+            }
+
+          /* Remove in a different random order, verifying as we
+             go. */
+          shuffle (order, size);
+          for (i = 0; i < size; i++) 
+            {
+              ASSERT (rb_remove (&tree, &order[i]->elem) == &order[i]->elem);
+              verify_tree (&tree, size - i - 1);
+            }
+          ASSERT (rb_empty (&tree));
+        }
+    }
+  
+  printf (" done\n");
+  printf ("rbtree: PASS\n");
+}
+
+/* Shuffles the CNT elements in ARRAY into random order. */
+static void
+shuffle (struct value **array, size_t cnt) 
+{
+  size_t i;
+
+  for (i = 0; i < cnt; i++)
+    {
+      size_t j = i + random_ulong () % (cnt - i);
+      struct value *t = array[j];
+      array[j] = array[i];
+      array[i] = t;
+    }
+}
+
+/* Returns true if value A is less than value B, false
+   otherwise. */
+static bool
+value_less (const struct rb_elem *a_, const struct rb_elem *b_,
+            void *aux UNUSED) 
+{
+  const struct value *a = rb_entry (a_, struct value, elem);
+  const struct value *b = rb_entry (b_, struct value, elem);
+  
+  return a->value < b->value;
+}
+
+/* Verifies the red-black invariants in the subtree rooted at E,
+   whose parent should be PARENT, and returns its black height. */
+static int
+verify_subtree (const struct rb_elem *e, const struct rb_elem *parent) 
+{
+  int left, right;
+
+  if (e == NULL)
+    return 1;
+
+  ASSERT (e->parent == parent);
+  ASSERT (!e->red || ((e->left == NULL || !e->left->red)
+                      && (e->right == NULL || !e->right->red)));
+  left = verify_subtree (e->left, e);
+  right = verify_subtree (e->right, e);
+  ASSERT (left == right);
+  return left + !e->red;
+}
+
+/* Verifies that TREE is a valid red-black tree with SIZE
+   elements, in order both ways, with equal values in insertion
+   order. */
+static void
+verify_tree (struct rb_tree *tree, size_t size) 
+{
+  struct rb_elem *e, *prev;
+  size_t cnt;
+
+  ASSERT (rb_size (tree) == size);
+  ASSERT (tree->root == NULL || !tree->root->red);
+  verify_subtree (tree->root, NULL);
+
+  prev = NULL;
+  cnt = 0;
+  for (e = rb_min (tree); e != NULL; e = rb_next (e)) 
+    {
+      ASSERT (rb_prev (e) == prev);
+      if (prev != NULL) 
+        {
+          struct value *a = rb_entry (prev, struct value, elem);
+          struct value *b = rb_entry (e, struct value, elem);
+          ASSERT (a->value < b->value
+                  || (a->value == b->value && a->seq < b->seq));
+        }
+      prev = e;
+      cnt++;
+    }
+  ASSERT (prev == rb_max (tree));
+  ASSERT (cnt == size);
+}
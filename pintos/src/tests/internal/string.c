@@ -0,0 +1,348 @@
+/* Test program for the word-at-a-time functions in
+   lib/string.c.
+
+   Checks memcpy(), memmove(), and memset() against simple
+   byte-at-a-time versions over every combination of source and
+   destination misalignment, including overlapping moves.  Does
+   the same for strlen(), strcmp(), memcmp(), memchr(), and
+   strchr(), with strings placed at every alignment and ending
+   right at a page boundary.  Then reports how many bytes per
+   cycle each function and its byte-at-a-time counterpart achieve
+   for sizes from 8 bytes to 64 kB.
+
+   This is not a test we will run on your submitted projects.
+   It is here for completeness.
+*/
+
+#undef NDEBUG
+#include <cpu.h>
+#include <debug.h>
+#include <inttypes.h>
+#include <random.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/test.h"
+#include "threads/vaddr.h"
+
+/* Largest block size that we will test or time. */
+#define MAX_SIZE 65536
+
+/* Number of times each block size is timed. */
+#define REPEAT_CNT 16
+
+/* Buffers, with room for misalignment and for overlapping moves. */
+static uint8_t buf[3 * MAX_SIZE];
+static uint8_t expect[3 * MAX_SIZE];
+
+static void verify_copy (size_t size);
+static void verify_set (size_t size);
+static void verify_search (size_t size);
+static void benchmark (void);
+
+/* Test block function implementations. */
+void
+test (void) 
+{
+  size_t size;
+
+  printf ("testing various size blocks:");
+  for (size = 0; size < 2048; size = size * 5 / 4 + 1)
+    {
+      printf (" %zu", size);
+      verify_copy (size);
+      verify_set (size);
+      if (size < 256)
+        verify_search (size);
+    }
+  printf (" done\n");
+
+  benchmark ();
+  printf ("string: PASS\n");
+}
+
+/* Byte-at-a-time memmove(). */
+static void
+byte_move (uint8_t *dst, const uint8_t *src, size_t size) 
+{
+  size_t i;
+
+  if (dst < src)
+    for (i = 0; i < size; i++)
+      dst[i] = src[i];
+  else
+    for (i = size; i-- > 0; )
+      dst[i] = src[i];
+}
+
+/* Byte-at-a-time memset(). */
+static void
+byte_set (uint8_t *dst, int value, size_t size) 
+{
+  while (size-- > 0)
+    *dst++ = value;
+}
+
+/* Fills BUF and EXPECT with the same random bytes. */
+static void
+randomize (void) 
+{
+  random_bytes (buf, sizeof buf);
+  memcpy (expect, buf, sizeof buf);
+}
+
+/* Checks that memcpy() and memmove() of SIZE bytes agree with
+   byte_move() for each source and destination offset in the
+   first few words, both for separate and overlapping blocks. */
+static void
+verify_copy (size_t size) 
+{
+  size_t dst_ofs, src_ofs;
+
+  for (dst_ofs = 0; dst_ofs < 8; dst_ofs++)
+    for (src_ofs = 0; src_ofs < 8; src_ofs++) 
+      {
+        size_t gap;
+
+        /* Separate blocks. */
+        random_bytes (buf, 2 * size + 32);
+        memcpy (expect, buf, 2 * size + 32);
+        ASSERT (memcpy (buf + size + 16 + dst_ofs, buf + src_ofs, size)
+                == buf + size + 16 + dst_ofs);
+        byte_move (expect + size + 16 + dst_ofs, expect + src_ofs, size);
+        ASSERT (!memcmp (buf, expect, 2 * size + 32));
+
+        /* Overlapping blocks, in both directions. */
+        for (gap = 1; gap <= 9; gap += 4) 
+          {
+            random_bytes (buf, size + 32);
+            memcpy (expect, buf, size + 32);
+            ASSERT (memmove (buf + src_ofs + gap + dst_ofs, buf + src_ofs, size)
+                    == buf + src_ofs + gap + dst_ofs);
+            byte_move (expect + src_ofs + gap + dst_ofs, expect + src_ofs,
+                       size);
+            ASSERT (!memcmp (buf, expect, size + 32));
+
+            random_bytes (buf, size + 32);
+            memcpy (expect, buf, size + 32);
+            ASSERT (memmove (buf + dst_ofs, buf + dst_ofs + gap + src_ofs, size)
+                    == buf + dst_ofs);
+            byte_move (expect + dst_ofs, expect + dst_ofs + gap + src_ofs,
+                       size);
+            ASSERT (!memcmp (buf, expect, size + 32));
+          }
+      }
+}
+
+/* Checks that memset() of SIZE bytes agrees with byte_set() at
+   each offset in the first few words and never writes outside
+   the block. */
+static void
+verify_set (size_t size) 
+{
+  size_t ofs;
+
+  for (ofs = 0; ofs < 8; ofs++) 
+    {
+      int value = random_ulong () % 512 - 128;
+
+      random_bytes (buf, size + 16);
+      memcpy (expect, buf, size + 16);
+      ASSERT (memset (buf + ofs, value, size) == buf + ofs);
+      byte_set (expect + ofs, value, size);
+      ASSERT (!memcmp (buf, expect, size + 16));
+    }
+}
+
+/* Byte-at-a-time strlen(). */
+static size_t
+byte_strlen (const char *s) 
+{
+  size_t len = 0;
+
+  while (s[len] != '\0')
+    len++;
+  return len;
+}
+
+/* Byte-at-a-time strcmp(), returning -1, 0, or 1. */
+static int
+byte_strcmp (const char *a_, const char *b_) 
+{
+  const unsigned char *a = (const unsigned char *) a_;
+  const unsigned char *b = (const unsigned char *) b_;
+
+  while (*a != '\0' && *a == *b) 
+    {
+      a++;
+      b++;
+    }
+  return *a < *b ? -1 : *a > *b;
+}
+
+/* Byte-at-a-time memcmp(), returning -1, 0, or 1. */
+static int
+byte_memcmp (const uint8_t *a, const uint8_t *b, size_t size) 
+{
+  for (; size-- > 0; a++, b++)
+    if (*a != *b)
+      return *a > *b ? +1 : -1;
+  return 0;
+}
+
+/* Byte-at-a-time memchr(). */
+static const void *
+byte_memchr (const uint8_t *block, uint8_t ch, size_t size) 
+{
+  for (; size-- > 0; block++)
+    if (*block == ch)
+      return block;
+  return NULL;
+}
+
+/* Byte-at-a-time strchr(). */
+static const char *
+byte_strchr (const char *s, char c) 
+{
+  for (;; s++)
+    if (*s == c)
+      return s;
+    else if (*s == '\0')
+      return NULL;
+}
+
+/* Reduces a comparison result to -1, 0, or 1. */
+static int
+sign (int x) 
+{
+  return (x > 0) - (x < 0);
+}
+
+/* Fills the SIZE bytes at DST with random characters from a
+   small alphabet, so that searches and comparisons often
+   match, and appends a null terminator. */
+static void
+random_string (char *dst, size_t size) 
+{
+  size_t i;
+
+  for (i = 0; i < size; i++)
+    dst[i] = "ab\x80\xff"[random_ulong () % 4];
+  dst[size] = '\0';
+}
+
+/* Checks the search and comparison functions against their
+   byte-at-a-time counterparts on strings of SIZE characters.
+   The first string ends right at the end of a page and the
+   second starts at each offset within a word, so that every
+   word-alignment case and the page boundary are covered. */
+static void
+verify_search (size_t size) 
+{
+  static char page[3 * PGSIZE] __attribute__ ((aligned (PGSIZE)));
+  char *a = page + 2 * PGSIZE - size - 1;
+  size_t ofs;
+
+  for (ofs = 0; ofs < 8; ofs++) 
+    {
+      char *b = page + ofs;
+      size_t len, i;
+
+      random_string (a, size);
+      memcpy (b, a, size + 1);
+      if (size > 0)
+        b[random_ulong () % size] = "ab\x80\xff"[random_ulong () % 4];
+
+      ASSERT (strlen (a) == byte_strlen (a));
+      ASSERT (strlen (b) == byte_strlen (b));
+      ASSERT (sign (strcmp (a, b)) == byte_strcmp (a, b));
+      ASSERT (sign (strcmp (b, a)) == byte_strcmp (b, a));
+      ASSERT (sign (memcmp (a, b, size))
+              == byte_memcmp ((uint8_t *) a, (uint8_t *) b, size));
+
+      for (i = 0; i < 5; i++) 
+        {
+          char c = "ab\x80\xff"[i];
+          ASSERT (strchr (a, c) == byte_strchr (a, c));
+          ASSERT (strchr (b, c) == byte_strchr (b, c));
+          ASSERT (memchr (a, c, size)
+                  == byte_memchr ((uint8_t *) a, c, size));
+        }
+
+      /* Shorter strings, which end partway through a word. */
+      len = size > 0 ? random_ulong () % size : 0;
+      b[len] = '\0';
+      ASSERT (strlen (b) == len);
+      ASSERT (sign (strcmp (a, b)) == byte_strcmp (a, b));
+      ASSERT (sign (strcmp (b, a)) == byte_strcmp (b, a));
+    }
+}
+
+/* Returns the bytes per cycle, in hundredths, of moving SIZE
+   bytes REPEAT_CNT times in CYCLES cycles. */
+static unsigned
+rate (size_t size, uint64_t cycles) 
+{
+  return cycles > 0 ? (uint64_t) size * REPEAT_CNT * 100 / cycles : 0;
+}
+
+/* Prints bytes per cycle for each block function and its
+   byte-at-a-time counterpart, for sizes from 8 bytes to
+   MAX_SIZE, with the source one byte off the destination's
+   alignment so that none of them gets a free ride. */
+static void
+benchmark (void) 
+{
+  size_t size;
+
+  if (!(cpu_features () & CPU_TSC)) 
+    {
+      printf ("no time-stamp counter, skipping benchmark\n");
+      return;
+    }
+
+  randomize ();
+  printf ("bytes/cycle     memcpy   (byte)  memmove   (byte)   memset   (byte)\n");
+  for (size = 8; size <= MAX_SIZE; size *= 2) 
+    {
+      uint64_t start, cycles[6];
+      int i;
+
+      start = rdtsc ();
+      for (i = 0; i < REPEAT_CNT; i++)
+        memcpy (buf + MAX_SIZE + 4, buf + 1, size);
+      cycles[0] = rdtsc () - start;
+
+      start = rdtsc ();
+      for (i = 0; i < REPEAT_CNT; i++)
+        byte_move (buf + MAX_SIZE + 4, buf + 1, size);
+      cycles[1] = rdtsc () - start;
+
+      start = rdtsc ();
+      for (i = 0; i < REPEAT_CNT; i++)
+        memmove (buf + 9, buf + 1, size);
+      cycles[2] = rdtsc () - start;
+
+      start = rdtsc ();
+      for (i = 0; i < REPEAT_CNT; i++)
+        byte_move (buf + 9, buf + 1, size);
+      cycles[3] = rdtsc () - start;
+
+      start = rdtsc ();
+      for (i = 0; i < REPEAT_CNT; i++)
+        memset (buf + 1, i, size);
+      cycles[4] = rdtsc () - start;
+
+      start = rdtsc ();
+      for (i = 0; i < REPEAT_CNT; i++)
+        byte_set (buf + 1, i, size);
+      cycles[5] = rdtsc () - start;
+
+      printf ("%6zu bytes", size);
+      for (i = 0; i < 6; i++) 
+        {
+          unsigned r = rate (size, cycles[i]);
+          printf (" %5u.%02u", r / 100, r % 100);
+        }
+      printf ("\n");
+    }
+}
@@ -0,0 +1,141 @@
+/* Stress test for priority donation.
+
+   First the main thread, at PRI_MIN, holds lock 0 of a chain of
+   CHAIN_DEPTH locks.  Thread i acquires lock i and then blocks
+   on lock i - 1, so each new thread's priority must travel down
+   a chain that is one lock longer than the last, well past the
+   8 levels that Pintos requires.
+
+   Then the main thread holds a single lock while WAITER_CNT
+   threads with distinct priorities, created in scrambled order,
+   block on it.  Releasing the lock must hand it to the waiters
+   strictly in descending order of priority.
+
+   The latency of each release, in CPU cycles from the call to
+   lock_release() until the highest-priority waiter holds the
+   lock, is reported, but only the ordering and priorities are
+   checked. */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/stats.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+
+#define CHAIN_DEPTH 40
+#define WAITER_CNT 60
+
+struct lock_pair
+  {
+    struct lock *first;         /* Lock to hold while waiting. */
+    struct lock *second;        /* Lock to wait for. */
+  };
+
+static thread_func chain_thread_func;
+static thread_func waiter_thread_func;
+
+static struct lock chain_locks[CHAIN_DEPTH];
+static struct lock_pair chain_pairs[CHAIN_DEPTH];
+
+static struct lock waiter_lock;
+static int waiter_order[WAITER_CNT];
+static int waiter_cnt;
+
+/* When main called lock_release(), and when the first waiter
+   then acquired the lock, from stats_clock(). */
+static uint64_t release_start;
+static uint64_t release_end;
+
+void
+test_priority_donate_deep (void)
+{
+  int i;
+
+  /* This test does not work with the MLFQS. */
+  ASSERT (!thread_mlfqs);
+
+  thread_set_priority (PRI_MIN);
+
+  /* Deep chain. */
+  for (i = 0; i < CHAIN_DEPTH; i++)
+    lock_init (&chain_locks[i]);
+  lock_acquire (&chain_locks[0]);
+  for (i = 1; i < CHAIN_DEPTH; i++)
+    {
+      char name[16];
+      int priority = PRI_MIN + i;
+
+      snprintf (name, sizeof name, "chain %d", i);
+      chain_pairs[i].first = &chain_locks[i];
+      chain_pairs[i].second = &chain_locks[i - 1];
+      thread_create (name, priority, chain_thread_func, &chain_pairs[i]);
+      if (thread_get_priority () != priority)
+        fail ("after %d-lock chain, main has priority %d, should be %d",
+              i, thread_get_priority (), priority);
+    }
+  msg ("Main received priority %d through a %d-lock chain.",
+       thread_get_priority (), CHAIN_DEPTH - 1);
+
+  release_start = stats_clock ();
+  lock_release (&chain_locks[0]);
+  msg ("Chain release latency: %"PRIu64" cycles.",
+       release_end - release_start);
+  msg ("Main has priority %d after releasing the chain.",
+       thread_get_priority ());
+
+  /* Many waiters. */
+  lock_init (&waiter_lock);
+  lock_acquire (&waiter_lock);
+  for (i = 0; i < WAITER_CNT; i++)
+    {
+      char name[16];
+
+      /* 7 and WAITER_CNT are relatively prime, so this visits
+         every priority from PRI_MIN + 1 to PRI_MIN + WAITER_CNT
+         exactly once. */
+      int priority = PRI_MIN + 1 + (i * 7) % WAITER_CNT;
+      snprintf (name, sizeof name, "waiter %d", priority);
+      thread_create (name, priority, waiter_thread_func, NULL);
+    }
+  msg ("Main received priority %d from %d waiters.",
+       thread_get_priority (), WAITER_CNT);
+
+  release_start = stats_clock ();
+  lock_release (&waiter_lock);
+  msg ("Waiter release latency: %"PRIu64" cycles.",
+       release_end - release_start);
+
+  if (waiter_cnt != WAITER_CNT)
+    fail ("only %d of %d waiters acquired the lock", waiter_cnt, WAITER_CNT);
+  for (i = 0; i < WAITER_CNT; i++)
+    if (waiter_order[i] != PRI_MIN + WAITER_CNT - i)
+      fail ("waiter %d acquired the lock in position %d",
+            waiter_order[i], i);
+  msg ("Waiters acquired the lock in priority order.");
+  msg ("Main finishing with priority %d.", thread_get_priority ());
+}
+
+static void
+chain_thread_func (void *pair_)
+{
+  struct lock_pair *pair = pair_;
+
+  lock_acquire (pair->first);
+  lock_acquire (pair->second);
+  if (pair->second == &chain_locks[0])
+    release_end = stats_clock ();
+  lock_release (pair->second);
+  lock_release (pair->first);
+}
+
+static void
+waiter_thread_func (void *aux UNUSED)
+{
+  lock_acquire (&waiter_lock);
+  if (waiter_cnt == 0)
+    release_end = stats_clock ();
+  waiter_order[waiter_cnt++] = thread_get_priority ();
+  lock_release (&waiter_lock);
+}
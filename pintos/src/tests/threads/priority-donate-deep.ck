@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+@output = grep (!/release latency: \d+ cycles\.$/, @output);
+compare_output ("run", \@output, [<<'EOF']);
+(priority-donate-deep) begin
+(priority-donate-deep) Main received priority 39 through a 39-lock chain.
+(priority-donate-deep) Main has priority 0 after releasing the chain.
+(priority-donate-deep) Main received priority 60 from 60 waiters.
+(priority-donate-deep) Waiters acquired the lock in priority order.
+(priority-donate-deep) Main finishing with priority 0.
+(priority-donate-deep) end
+EOF
+pass;
@@ -0,0 +1,61 @@
+/* Checks that readers share a reader-writer lock, that a waiting
+   writer keeps new readers out, and that a reader blocked behind
+   a writer donates its priority to the writer.
+
+   The main thread holds the lock for reading.  A higher-priority
+   reader gets in alongside it.  Then a writer arrives and waits
+   for main to leave, and a reader with still higher priority
+   arrives after the writer and must wait for it.  When main
+   releases its read lock, the writer runs first, with the
+   second reader's priority. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+
+static thread_func reader_func;
+static thread_func writer_func;
+
+void
+test_rwlock (void) 
+{
+  struct rwlock rw;
+
+  /* This test does not work with the MLFQS. */
+  ASSERT (!thread_mlfqs);
+
+  /* Make sure our priority is the default. */
+  ASSERT (thread_get_priority () == PRI_DEFAULT);
+
+  rwlock_init (&rw);
+  rwlock_acquire_read (&rw);
+  thread_create ("reader 1", PRI_DEFAULT + 1, reader_func, &rw);
+  thread_create ("writer", PRI_DEFAULT + 2, writer_func, &rw);
+  thread_create ("reader 2", PRI_DEFAULT + 3, reader_func, &rw);
+  msg ("Main releasing read lock.");
+  rwlock_release_read (&rw);
+  msg ("Main finished.");
+}
+
+static void
+reader_func (void *rw_) 
+{
+  struct rwlock *rw = rw_;
+
+  rwlock_acquire_read (rw);
+  msg ("%s reading.", thread_name ());
+  rwlock_release_read (rw);
+}
+
+static void
+writer_func (void *rw_) 
+{
+  struct rwlock *rw = rw_;
+
+  rwlock_acquire_write (rw);
+  msg ("Writer writing with priority %d.", thread_get_priority ());
+  rwlock_release_write (rw);
+  msg ("Writer finished with priority %d.", thread_get_priority ());
+}
@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(rwlock) begin
+(rwlock) reader 1 reading.
+(rwlock) Main releasing read lock.
+(rwlock) Writer writing with priority 34.
+(rwlock) reader 2 reading.
+(rwlock) Writer finished with priority 33.
+(rwlock) Main finished.
+(rwlock) end
+EOF
+pass;
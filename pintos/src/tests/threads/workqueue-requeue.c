@@ -0,0 +1,52 @@
+/* A work item queues itself again from its own work function,
+   then sleeps so that the other worker is free to take it.
+   Checks that the runs never overlap and that flush_work() does
+   not return until the last of them has finished. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/interrupt.h"
+#include "threads/thread.h"
+#include "threads/workqueue.h"
+#include "devices/timer.h"
+
+/* Number of times the work item runs. */
+#define RUN_CNT 5
+
+static work_func requeue_work;
+
+static int runs;                /* Runs started so far. */
+static int active;              /* Runs in progress. */
+static bool overlapped;         /* Did two runs ever overlap? */
+
+void
+test_workqueue_requeue (void) 
+{
+  struct work w;
+  enum intr_level old_level;
+  bool idle;
+
+  work_init (&w, requeue_work, NULL, WORK_NORMAL);
+  queue_work (&w);
+  flush_work (&w);
+
+  old_level = intr_disable ();
+  idle = !w.pending && !w.running && active == 0;
+  intr_set_level (old_level);
+
+  msg ("Ran %d times.", runs);
+  msg ("Runs overlapped: %s.", overlapped ? "yes" : "no");
+  msg ("Idle after flush: %s.", idle ? "yes" : "no");
+}
+
+static void
+requeue_work (struct work *w) 
+{
+  if (active++ > 0)
+    overlapped = true;
+  if (++runs < RUN_CNT)
+    queue_work (w);
+  timer_sleep (2);
+  active--;
+}
@@ -0,0 +1,12 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(workqueue-requeue) begin
+(workqueue-requeue) Ran 5 times.
+(workqueue-requeue) Runs overlapped: no.
+(workqueue-requeue) Idle after flush: yes.
+(workqueue-requeue) end
+EOF
+pass;
@@ -0,0 +1,49 @@
+/* Queues work items at each work queue priority and checks that
+   the workers run them highest priority first, that a pending
+   item cannot be queued twice, that flush_work() waits for an
+   item to finish, and that a pending item can be cancelled.
+
+   The main thread runs above the workers' priority while it
+   queues, so that nothing runs until it flushes. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/thread.h"
+#include "threads/workqueue.h"
+
+static work_func record_work;
+
+void
+test_workqueue (void) 
+{
+  struct work high, normal, low;
+
+  thread_set_priority (PRI_DEFAULT + 1);
+
+  work_init (&low, record_work, "low", WORK_LOW);
+  work_init (&normal, record_work, "normal", WORK_NORMAL);
+  work_init (&high, record_work, "high", WORK_HIGH);
+  queue_work (&low);
+  queue_work (&normal);
+  queue_work (&high);
+  msg ("Queuing pending work again: %s.",
+       queue_work (&low) ? "accepted" : "refused");
+
+  flush_work (&low);
+  flush_work (&normal);
+  flush_work (&high);
+  msg ("Flushed.");
+
+  queue_work (&normal);
+  msg ("Cancelled pending work: %s.", cancel_work (&normal) ? "yes" : "no");
+  flush_work (&normal);
+
+  thread_set_priority (PRI_DEFAULT);
+}
+
+static void
+record_work (struct work *w) 
+{
+  msg ("%s ran.", (const char *) w->aux);
+}
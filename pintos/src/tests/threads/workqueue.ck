@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(workqueue) begin
+(workqueue) Queuing pending work again: refused.
+(workqueue) high ran.
+(workqueue) normal ran.
+(workqueue) low ran.
+(workqueue) Flushed.
+(workqueue) Cancelled pending work: yes.
+(workqueue) end
+EOF
+pass;
@@ -0,0 +1,26 @@
+/* Child process run by pipe test.
+
+   Writes a message to the pipe write end whose file descriptor
+   is passed as the first command-line argument, which the
+   process inherited from its parent. */
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+
+const char *test_name = "child-pipe";
+
+int
+main (int argc UNUSED, char *argv[]) 
+{
+  static const char message[] = "hello from child-pipe";
+
+  if (!isdigit (*argv[1]))
+    fail ("bad command-line arguments");
+  if (write (atoi (argv[1]), message, strlen (message))
+      != (int) strlen (message))
+    fail ("write to inherited pipe failed");
+  return 0;
+}
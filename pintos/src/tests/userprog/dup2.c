@@ -0,0 +1,56 @@
+/* Redirects standard output to a pipe with dup2() while starting
+   a child process, which inherits the redirection, and checks
+   that the child's output arrives through the pipe.  Also
+   redirects standard input to a pipe and checks that closing a
+   redirected fd switches it back to the console. */
+
+#include <stdio.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void) 
+{
+  static const char child_output[] = "(child-simple) run\n";
+  char buf[64];
+  int fds[2];
+  int n, total;
+  int dup_result, status;
+  pid_t pid;
+
+  CHECK (pipe (fds), "pipe");
+  CHECK (dup2 (fds[0], -1) == -1, "dup2 to negative fd");
+  CHECK (dup2 (fds[1] + 100, fds[0]) == -1, "dup2 from closed fd");
+
+  /* Nothing may be printed while stdout goes to the pipe. */
+  dup_result = dup2 (fds[1], STDOUT_FILENO);
+  close (fds[1]);
+  pid = exec ("child-simple");
+  close (STDOUT_FILENO);
+  status = wait (pid);
+  CHECK (dup_result == STDOUT_FILENO, "dup2 write end to stdout");
+  CHECK (pid != PID_ERROR, "exec child-simple with redirected stdout");
+  msg ("wait(exec()) = %d", status);
+
+  for (total = 0;
+       (n = read (fds[0], buf + total, sizeof buf - total)) > 0; )
+    total += n;
+  CHECK (n == 0, "end of file after child exited");
+  CHECK (total == (int) strlen (child_output)
+         && !memcmp (buf, child_output, total),
+         "child output arrived through pipe");
+  close (fds[0]);
+
+  CHECK (pipe (fds), "pipe");
+  CHECK (write (fds[1], "xyz", 3) == 3, "write to pipe");
+  CHECK (dup2 (fds[0], STDIN_FILENO) == STDIN_FILENO,
+         "dup2 read end to stdin");
+  close (fds[0]);
+  CHECK (read (STDIN_FILENO, buf, sizeof buf) == 3
+         && !memcmp (buf, "xyz", 3), "read from redirected stdin");
+  close (STDIN_FILENO);
+  CHECK (write (fds[1], "x", 1) == -1, "write after stdin closed");
+  close (fds[1]);
+}
@@ -0,0 +1,24 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(dup2) begin
+(dup2) pipe
+(dup2) dup2 to negative fd
+(dup2) dup2 from closed fd
+child-simple: exit(81)
+(dup2) dup2 write end to stdout
+(dup2) exec child-simple with redirected stdout
+(dup2) wait(exec()) = 81
+(dup2) end of file after child exited
+(dup2) child output arrived through pipe
+(dup2) pipe
+(dup2) write to pipe
+(dup2) dup2 read end to stdin
+(dup2) read from redirected stdin
+(dup2) write after stdin closed
+(dup2) end
+dup2: exit(0)
+EOF
+pass;
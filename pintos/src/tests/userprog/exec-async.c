@@ -0,0 +1,39 @@
+/* Starts several children with exec_async() so that they load
+   concurrently, then checks each one's load status and exit
+   code.  Also checks that a child that cannot load gets a pid
+   but reports a failed load. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CHILD_CNT 4
+
+void
+test_main (void) 
+{
+  pid_t pids[CHILD_CNT];
+  int loaded = 0, exited = 0;
+  pid_t pid;
+  int i;
+
+  /* Start all the children before waiting for any of them, and
+     say nothing until they have all exited, so that the output
+     does not depend on how they are scheduled. */
+  for (i = 0; i < CHILD_CNT; i++)
+    if ((pids[i] = exec_async ("child-simple")) == PID_ERROR)
+      fail ("exec_async failed");
+  for (i = 0; i < CHILD_CNT; i++)
+    if (exec_status (pids[i], true) == 1)
+      loaded++;
+  for (i = 0; i < CHILD_CNT; i++)
+    if (wait (pids[i]) == 81)
+      exited++;
+  msg ("%d of %d children loaded", loaded, CHILD_CNT);
+  msg ("%d of %d children exited with 81", exited, CHILD_CNT);
+  CHECK (exec_status (pids[0], false) == -1, "status after wait");
+
+  CHECK ((pid = exec_async ("no-such-file")) != PID_ERROR,
+         "exec_async(\"no-such-file\")");
+  msg ("exec_status = %d", exec_status (pid, true));
+}
@@ -0,0 +1,19 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(exec-async) begin
+(child-simple) run
+(child-simple) run
+(child-simple) run
+(child-simple) run
+(exec-async) 4 of 4 children loaded
+(exec-async) 4 of 4 children exited with 81
+(exec-async) status after wait
+(exec-async) exec_async("no-such-file")
+load: no-such-file: open failed
+(exec-async) exec_status = -1
+(exec-async) end
+EOF
+pass;
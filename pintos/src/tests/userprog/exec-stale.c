@@ -0,0 +1,26 @@
+/* Runs a program, overwrites the start of its executable, and
+   then tries to run it again.  The second exec must fail: the
+   kernel must not reuse what it learned from the executable the
+   first time once the file has been written.
+
+   The kernel's cache of parsed executables relies on a write
+   changing the file's version, and notifying the cache, after
+   the new data is on disk as well as before it is written, so
+   that a load that overlaps a write cannot cache the old
+   headers. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void) 
+{
+  int handle;
+
+  msg ("wait(exec()) = %d", wait (exec ("child-simple")));
+  CHECK ((handle = open ("child-simple")) > 1, "open \"child-simple\"");
+  CHECK (write (handle, "XXXX", 4) == 4, "overwrite ELF header");
+  close (handle);
+  msg ("exec(\"child-simple\"): %d", exec ("child-simple"));
+}
@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(exec-stale) begin
+(child-simple) run
+child-simple: exit(81)
+(exec-stale) wait(exec()) = 81
+(exec-stale) open "child-simple"
+(exec-stale) overwrite ELF header
+load: child-simple: error loading executable
+(exec-stale) exec("child-simple"): -1
+(exec-stale) end
+exec-stale: exit(0)
+EOF
+pass;
@@ -0,0 +1,51 @@
+/* Writes a file and reads it back through a batched I/O ring in
+   a single ioring_enter() call, along with requests that must
+   fail without killing the process. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/userprog/sample.inc"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+static struct ioring ring;
+static char buf[sizeof sample];
+
+static void
+queue (int op, int fd, void *buffer, unsigned size, unsigned data)
+{
+  struct ioring_sqe *sqe = &ring.sq[ring.sq_tail++ % IORING_ENTRIES];
+
+  sqe->op = op;
+  sqe->fd = fd;
+  sqe->buffer = buffer;
+  sqe->size = size;
+  sqe->offset = 0;
+  sqe->data = data;
+}
+
+void
+test_main (void)
+{
+  int fd;
+
+  CHECK (create ("ring.txt", sizeof sample - 1), "create \"ring.txt\"");
+  CHECK ((fd = open ("ring.txt")) > 1, "open \"ring.txt\"");
+  CHECK (ioring_setup (&ring), "ioring_setup");
+
+  queue (IORING_WRITE, fd, sample, sizeof sample - 1, 1);
+  queue (IORING_NOP, fd, NULL, 0, 2);
+  queue (IORING_READ, fd, buf, sizeof sample - 1, 3);
+  queue (IORING_READ, fd + 1, buf, sizeof sample - 1, 4);
+  queue (IORING_READ, fd, (void *) test_main, sizeof sample - 1, 5);
+  CHECK (ioring_enter () == 5, "ioring_enter");
+
+  for (; ring.cq_head != ring.cq_tail; ring.cq_head++)
+    {
+      struct ioring_cqe *cqe = &ring.cq[ring.cq_head % IORING_ENTRIES];
+      msg ("request %u: %d", cqe->data, cqe->result);
+    }
+  if (strcmp (buf, sample))
+    fail ("data read back differs from data written");
+  msg ("data matches");
+}
@@ -0,0 +1,20 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(ioring) begin
+(ioring) create "ring.txt"
+(ioring) open "ring.txt"
+(ioring) ioring_setup
+(ioring) ioring_enter
+(ioring) request 1: 239
+(ioring) request 2: 0
+(ioring) request 3: 239
+(ioring) request 4: -1
+(ioring) request 5: -1
+(ioring) data matches
+(ioring) end
+ioring: exit(0)
+EOF
+pass;
@@ -0,0 +1,59 @@
+/* Streams data through a pipe, both within one process and from
+   a child process that inherits the pipe's write end, and checks
+   end-of-file and broken-pipe behavior. */
+
+#include <stdio.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CHUNK 3000
+
+static char out[CHUNK];
+static char in[CHUNK];
+
+void
+test_main (void) 
+{
+  char child_cmd[128];
+  int fds[2];
+  int i, n, total;
+
+  CHECK (pipe (fds), "pipe");
+  CHECK (fds[0] > 1 && fds[1] > 1 && fds[0] != fds[1], "distinct fds");
+
+  /* Three chunks of this size wrap around the pipe's buffer. */
+  for (i = 0; i < 3; i++)
+    {
+      memset (out, 'a' + i, sizeof out);
+      if (write (fds[1], out, sizeof out) != CHUNK)
+        fail ("write %d failed", i);
+      for (total = 0; total < CHUNK; total += n)
+        {
+          n = read (fds[0], in + total, CHUNK - total);
+          if (n <= 0)
+            fail ("read %d returned %d", i, n);
+        }
+      if (memcmp (in, out, CHUNK))
+        fail ("chunk %d corrupted", i);
+    }
+  msg ("round trips through pipe");
+  CHECK (read (fds[1], in, 1) == -1, "read from write end");
+  CHECK (write (fds[0], out, 1) == -1, "write to read end");
+
+  snprintf (child_cmd, sizeof child_cmd, "child-pipe %d", fds[1]);
+  msg ("wait(exec()) = %d", wait (exec (child_cmd)));
+  close (fds[1]);
+
+  for (total = 0; (n = read (fds[0], in + total, CHUNK - total)) > 0; )
+    total += n;
+  CHECK (n == 0, "end of file after last writer closed");
+  in[total] = '\0';
+  msg ("read \"%s\"", in);
+  close (fds[0]);
+
+  CHECK (pipe (fds), "pipe");
+  close (fds[0]);
+  CHECK (write (fds[1], out, 1) == -1, "write with no reader");
+}
@@ -0,0 +1,21 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(pipe) begin
+(pipe) pipe
+(pipe) distinct fds
+(pipe) round trips through pipe
+(pipe) read from write end
+(pipe) write to read end
+child-pipe: exit(0)
+(pipe) wait(exec()) = 0
+(pipe) end of file after last writer closed
+(pipe) read "hello from child-pipe"
+(pipe) pipe
+(pipe) write with no reader
+(pipe) end
+pipe: exit(0)
+EOF
+pass;
@@ -0,0 +1,50 @@
+/* Writes a file with writev() and pwrite(), reads it back with
+   readv() and pread(), and checks that only the vectored calls
+   move the file position. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/userprog/sample.inc"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+static char buf[sizeof sample];
+
+void
+test_main (void)
+{
+  size_t size = sizeof sample - 1;
+  struct iovec iov[3];
+  int fd;
+
+  CHECK (create ("vector.txt", size), "create \"vector.txt\"");
+  CHECK ((fd = open ("vector.txt")) > 1, "open \"vector.txt\"");
+
+  iov[0].iov_base = sample;
+  iov[0].iov_len = 10;
+  iov[1].iov_base = sample + 10;
+  iov[1].iov_len = 0;
+  iov[2].iov_base = sample + 10;
+  iov[2].iov_len = size - 10;
+  CHECK (writev (fd, iov, 3) == (int) size, "writev %zu bytes", size);
+  CHECK (tell (fd) == size, "tell after writev");
+
+  CHECK (pwrite (fd, "XYZ", 3, 20) == 3, "pwrite 3 bytes at offset 20");
+  CHECK (tell (fd) == size, "tell after pwrite");
+  CHECK (pread (fd, buf, 5, 19) == 5, "pread 5 bytes at offset 19");
+  if (memcmp (buf, sample + 19, 1) || memcmp (buf + 1, "XYZ", 3)
+      || memcmp (buf + 4, sample + 23, 1))
+    fail ("pread returned wrong data");
+  CHECK (pwrite (fd, sample + 20, 3, 20) == 3, "restore offset 20");
+
+  seek (fd, 0);
+  iov[0].iov_base = buf;
+  iov[0].iov_len = 100;
+  iov[1].iov_base = buf + 100;
+  iov[1].iov_len = sizeof buf - 100;
+  CHECK (readv (fd, iov, 2) == (int) size, "readv %zu bytes", size);
+  CHECK (tell (fd) == size, "tell after readv");
+  if (memcmp (buf, sample, size))
+    fail ("readv returned wrong data");
+  CHECK (readv (fd, iov, -1) == -1, "readv with negative count");
+}
@@ -0,0 +1,21 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(rw-vector) begin
+(rw-vector) create "vector.txt"
+(rw-vector) open "vector.txt"
+(rw-vector) writev 239 bytes
+(rw-vector) tell after writev
+(rw-vector) pwrite 3 bytes at offset 20
+(rw-vector) tell after pwrite
+(rw-vector) pread 5 bytes at offset 19
+(rw-vector) restore offset 20
+(rw-vector) readv 239 bytes
+(rw-vector) tell after readv
+(rw-vector) readv with negative count
+(rw-vector) end
+rw-vector: exit(0)
+EOF
+pass;
@@ -0,0 +1,44 @@
+/* Reads the kernel statistics with stats() and checks that the
+   null system calls made just before are counted, and that a
+   buffer that is too small receives only what fits. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CALL_CNT 10
+
+static char buf[16384];
+
+void
+test_main (void) 
+{
+  const char *hist;
+  int length, count, i;
+
+  CHECK ((length = stats (NULL, 0)) > 0, "stats(NULL, 0)");
+
+  for (i = 0; i < CALL_CNT; i++)
+    null_syscall ();
+  length = stats (buf, sizeof buf - 1);
+  if (length <= 0 || length >= (int) sizeof buf)
+    fail ("stats returned %d", length);
+  buf[length] = '\0';
+
+  /* The null calls are recorded when they return, so all of
+     them have been counted by now. */
+  hist = strstr (buf, "hist syscall.null ");
+  if (hist == NULL)
+    fail ("no syscall.null histogram");
+  count = atoi (hist + strlen ("hist syscall.null "));
+  if (count < CALL_CNT)
+    fail ("syscall.null count %d, expected at least %d", count, CALL_CNT);
+  msg ("syscall.null counted");
+
+  memset (buf, 'x', sizeof buf);
+  CHECK (stats (buf, 8) > 8, "stats(buf, 8)");
+  if (memcmp (buf, "counter ", 8) || buf[8] != 'x')
+    fail ("short buffer not filled exactly");
+}
@@ -0,0 +1,13 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(stats) begin
+(stats) stats(NULL, 0)
+(stats) syscall.null counted
+(stats) stats(buf, 8)
+(stats) end
+stats: exit(0)
+EOF
+pass;
@@ -0,0 +1,20 @@
+/* Waits for any child with wait_any(), then verifies that the
+   reaped child can no longer be waited for. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void) 
+{
+  int status = 0;
+  pid_t pid = exec ("child-simple");
+  pid_t reaped = wait_any (&status);
+
+  if (reaped != pid)
+    fail ("wait_any() returned %d instead of %d", reaped, pid);
+  msg ("wait_any() reaped child with status %d", status);
+  msg ("wait_any() = %d", wait_any (NULL));
+  msg ("wait(pid) = %d", wait (pid));
+}
@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(wait-any) begin
+(child-simple) run
+child-simple: exit(81)
+(wait-any) wait_any() reaped child with status 81
+(wait-any) wait_any() = -1
+(wait-any) wait(pid) = -1
+(wait-any) end
+wait-any: exit(0)
+EOF
+pass;
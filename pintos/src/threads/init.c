@@ -20,8 +20,12 @@
 #include "threads/loader.h"
 #include "threads/malloc.h"
 #include "threads/palloc.h"
+#include "threads/synch.h"
 #include "threads/pte.h"
+#include "threads/profile.h"
 #include "threads/thread.h"
+#include "threads/trace.h"
+#include "threads/workqueue.h"
 #ifdef USERPROG
 #include "userprog/process.h"
 #include "userprog/exception.h"
@@ -31,6 +35,7 @@
 #else
 #include "tests/threads/tests.h"
 #endif
+#include "tests/bench/bench.h"
 #ifdef FILESYS
 #include "devices/block.h"
 #include "devices/ide.h"
@@ -54,6 +59,12 @@ static const char *swap_bdev_name;
 #endif
 #endif /* FILESYS */
 
+/* -profile: Sampling rate in Hz, or 0 not to profile. */
+static unsigned profile_hz;
+
+/* -trace: Record kernel events? */
+static bool trace_kernel;
+
 /* -ul: Maximum number of pages to put into palloc's user pool. */
 static size_t user_page_limit = SIZE_MAX;
 
@@ -88,6 +99,7 @@ main (void)
   /* Initialize ourselves as a thread so we can use locks,
      then enable console locking. */
   thread_init ();
+  synch_init ();
   console_init ();  
 
   /* Greet user. */
@@ -98,6 +110,8 @@ main (void)
   palloc_init (user_page_limit);
   malloc_init ();
   paging_init ();
+  if (trace_kernel)
+    trace_start ();
 
   /* Segmentation. */
 #ifdef USERPROG
@@ -113,12 +127,17 @@ main (void)
 #ifdef USERPROG
   exception_init ();
   syscall_init ();
+  process_init ();
 #endif
 
   /* Start thread scheduler and enable interrupts. */
   thread_start ();
+  workqueue_init ();
   serial_init_queue ();
+  console_start ();
   timer_calibrate ();
+  if (profile_hz != 0)
+    profile_start (profile_hz);
 
 #ifdef FILESYS
   /* Initialize file system. */
@@ -256,6 +275,10 @@ parse_options (char **argv)
         random_init (atoi (value));
       else if (!strcmp (name, "-mlfqs"))
         thread_mlfqs = true;
+      else if (!strcmp (name, "-profile"))
+        profile_hz = value != NULL ? atoi (value) : TIMER_FREQ;
+      else if (!strcmp (name, "-trace"))
+        trace_kernel = true;
 #ifdef USERPROG
       else if (!strcmp (name, "-ul"))
         user_page_limit = atoi (value);
@@ -292,6 +315,14 @@ run_task (char **argv)
   printf ("Execution of '%s' complete.\n", task);
 }
 
+/* Runs the benchmark named in ARGV[1], or all of them if it is
+   "all". */
+static void
+run_benchmark (char **argv)
+{
+  run_bench (argv[1]);
+}
+
 /* Executes all of the actions specified in ARGV[]
    up to the null pointer sentinel. */
 static void
@@ -309,12 +340,14 @@ run_actions (char **argv)
   static const struct action actions[] = 
     {
       {"run", 2, run_task},
+      {"bench", 2, run_benchmark},
 #ifdef FILESYS
       {"ls", 1, fsutil_ls},
       {"cat", 2, fsutil_cat},
       {"rm", 2, fsutil_rm},
       {"extract", 1, fsutil_extract},
       {"append", 2, fsutil_append},
+      {"trace", 2, trace_save},
 #endif
       {NULL, 0, NULL},
     };
@@ -357,6 +390,7 @@ usage (void)
 #else
           "  run TEST           Run TEST.\n"
 #endif
+          "  bench NAME         Run benchmark NAME, or all if NAME is `all'.\n"
 #ifdef FILESYS
           "  ls                 List files in the root directory.\n"
           "  cat FILE           Print FILE to the console.\n"
@@ -364,6 +398,7 @@ usage (void)
           "Use these actions indirectly via `pintos' -g and -p options:\n"
           "  extract            Untar from scratch device into file system.\n"
           "  append FILE        Append FILE to tar file on scratch device.\n"
+          "  trace FILE         Save -trace events into FILE.\n"
 #endif
           "\nOptions:\n"
           "  -h                 Print this help message and power off.\n"
@@ -379,6 +414,8 @@ usage (void)
 #endif
           "  -rs=SEED           Set random number seed to SEED.\n"
           "  -mlfqs             Use multi-level feedback queue scheduler.\n"
+          "  -profile[=HZ]      Sample running code HZ times per second.\n"
+          "  -trace             Record kernel events for utils/pintos-trace.\n"
 #ifdef USERPROG
           "  -ul=COUNT          Limit user memory to COUNT pages.\n"
 #endif
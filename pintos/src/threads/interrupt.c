@@ -7,6 +7,7 @@
 #include "threads/intr-stubs.h"
 #include "threads/io.h"
 #include "threads/thread.h"
+#include "threads/trace.h"
 #include "threads/vaddr.h"
 #include "devices/timer.h"
 
@@ -359,6 +360,7 @@ intr_handler (struct intr_frame *frame)
 
       in_external_intr = true;
       yield_on_return = false;
+      trace (TRACE_IRQ_ENTER, frame->vec_no, 0);
     }
 
   /* Invoke the interrupt's handler. */
@@ -380,6 +382,7 @@ intr_handler (struct intr_frame *frame)
       ASSERT (intr_get_level () == INTR_OFF);
       ASSERT (intr_context ());
 
+      trace (TRACE_IRQ_EXIT, frame->vec_no, 0);
       in_external_intr = false;
       pic_end_of_interrupt (frame->vec_no); 
 
@@ -0,0 +1,190 @@
+#include "threads/profile.h"
+#include <debug.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "devices/timer.h"
+#include "threads/palloc.h"
+#include "threads/stats.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#ifdef USERPROG
+#include "userprog/pagedir.h"
+#endif
+
+/* Program counters recorded per sample. */
+#define PROFILE_DEPTH 8
+
+/* Pages of memory for the sample ring. */
+#define PROFILE_PAGES 32
+
+/* One sample. */
+struct sample
+  {
+    uint32_t pcs[PROFILE_DEPTH]; /* Interrupted PC, then return addresses. */
+    tid_t tid;                  /* Running thread. */
+    char name[16];              /* Running thread's name. */
+    uint8_t depth;              /* Number of valid `pcs'. */
+    bool user;                  /* Interrupted in user mode? */
+  };
+
+/* Sample ring.  Only profile_sample(), in the timer interrupt,
+   writes it. */
+static struct sample *samples;  /* Ring, or null if not profiling. */
+static size_t sample_cnt;       /* Number of slots in `samples'. */
+static uint64_t sample_total;   /* Samples ever taken. */
+static unsigned sample_hz;      /* Sampling rate. */
+
+static struct stat_counter samples_taken;
+
+/* Starts sampling HZ times per second.  If HZ is more than
+   TIMER_FREQ, the timer is sped up to interrupt that often, to
+   the nearest multiple of TIMER_FREQ, without changing the rate
+   at which timer ticks advance.  Must be called after
+   timer_init() and palloc_init(). */
+void
+profile_start (unsigned hz)
+{
+  ASSERT (samples == NULL);
+
+  if (hz < TIMER_FREQ)
+    hz = TIMER_FREQ;
+  if (hz > PROFILE_MAX_HZ)
+    hz = PROFILE_MAX_HZ;
+  sample_hz = timer_set_interrupt_freq (hz);
+
+  stats_register_counter (&samples_taken, "profile.samples");
+  sample_cnt = PROFILE_PAGES * PGSIZE / sizeof *samples;
+  samples = palloc_get_multiple (PAL_ASSERT | PAL_ZERO, PROFILE_PAGES);
+}
+
+/* Returns true if the 8 bytes at FRAME, a saved frame pointer
+   followed by a return address, lie within the page at PAGE. */
+static bool
+frame_in_page (uint32_t frame, uint32_t page)
+{
+  return frame % sizeof (uint32_t) == 0
+         && frame >= page && frame <= page + PGSIZE - 2 * sizeof (uint32_t);
+}
+
+/* Records the call chain of kernel code whose frame pointer is
+   EBP in S, following it only within the current thread's stack
+   page, where the interrupt frame itself is. */
+static void
+walk_kernel (struct sample *s, uint32_t ebp, const struct intr_frame *f)
+{
+  uint32_t page = (uint32_t) pg_round_down (f);
+
+  while (s->depth < PROFILE_DEPTH && frame_in_page (ebp, page))
+    {
+      const uint32_t *frame = (const uint32_t *) ebp;
+
+      if (frame[1] == 0)
+        break;
+      s->pcs[s->depth++] = frame[1];
+
+      /* Stacks grow down, so callers' frames are at higher
+         addresses.  Anything else ends the chain. */
+      if (frame[0] <= ebp)
+        break;
+      ebp = frame[0];
+    }
+}
+
+#ifdef USERPROG
+/* Records the call chain of user code whose frame pointer is EBP
+   in S.  Only frames in pages mapped in thread T's page directory
+   are read, so a bogus frame pointer cannot cause a fault. */
+static void
+walk_user (struct sample *s, uint32_t ebp, struct thread *t)
+{
+  while (s->depth < PROFILE_DEPTH && t->pagedir != NULL
+         && is_user_vaddr ((void *) ebp))
+    {
+      uint32_t page = (uint32_t) pg_round_down ((void *) ebp);
+      const uint32_t *frame;
+
+      if (!frame_in_page (ebp, page)
+          || (frame = pagedir_get_page (t->pagedir, (void *) ebp)) == NULL)
+        break;
+      if (frame[1] == 0)
+        break;
+      s->pcs[s->depth++] = frame[1];
+      if (frame[0] <= ebp)
+        break;
+      ebp = frame[0];
+    }
+}
+#endif
+
+/* Records a sample of the code interrupted by the timer
+   interrupt with frame F. */
+void
+profile_sample (const struct intr_frame *f)
+{
+  struct thread *t;
+  struct sample *s;
+
+  if (samples == NULL)
+    return;
+
+  t = thread_current ();
+  s = &samples[sample_total++ % sample_cnt];
+  s->tid = t->tid;
+  strlcpy (s->name, t->name, sizeof s->name);
+  s->user = (f->cs & 3) == 3;
+  s->pcs[0] = (uint32_t) f->eip;
+  s->depth = 1;
+  if (!s->user)
+    walk_kernel (s, f->ebp, f);
+#ifdef USERPROG
+  else
+    walk_user (s, f->ebp, t);
+#endif
+  stat_inc (&samples_taken);
+}
+
+/* Prints the samples in the ring, oldest first, one per line:
+
+     PROF NAME TID MODE PC...
+
+   where NAME is the thread name with spaces changed to
+   underscores, MODE is `u' for user or `k' for kernel, and each
+   PC is in hexadecimal, starting with the interrupted PC and
+   continuing with the return addresses of its callers.
+
+   Sampling stops first, so that the ring holds still while it is
+   printed. */
+void
+profile_print (void)
+{
+  struct sample *ring = samples;
+  uint64_t first, i;
+
+  if (ring == NULL)
+    return;
+  samples = NULL;
+  barrier ();
+
+  first = sample_total > sample_cnt ? sample_total - sample_cnt : 0;
+  printf ("Profile: %llu samples at %u Hz, %llu overwritten\n",
+          sample_total, sample_hz, first);
+  for (i = first; i < sample_total; i++)
+    {
+      struct sample *s = &ring[i % sample_cnt];
+      char name[sizeof s->name];
+      char *p;
+      int d;
+
+      strlcpy (name, s->name, sizeof name);
+      for (p = name; *p != '\0'; p++)
+        if (*p == ' ')
+          *p = '_';
+      printf ("PROF %s %d %c", name, s->tid, s->user ? 'u' : 'k');
+      for (d = 0; d < s->depth; d++)
+        printf (" %08"PRIx32, s->pcs[d]);
+      printf ("\n");
+    }
+}
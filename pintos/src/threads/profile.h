@@ -0,0 +1,27 @@
+#ifndef THREADS_PROFILE_H
+#define THREADS_PROFILE_H
+
+#include "threads/interrupt.h"
+
+/* Sampling profiler.
+
+   Once started by the "-profile" kernel command-line option,
+   the timer interrupt records, on each interrupt, the
+   instruction that was interrupted and up to PROFILE_DEPTH - 1
+   return addresses found by following the frame pointer chain,
+   along with the running thread.  Samples are kept in a ring
+   that overwrites the oldest samples when full, and printed at
+   shutdown for utils/pintos-profile to symbolize.
+
+   Stacks are only as good as the frame pointer chain, so build
+   with -fno-omit-frame-pointer for reliable call chains; the
+   interrupted instruction is always accurate. */
+
+/* Highest sampling rate, in Hz, that "-profile" accepts. */
+#define PROFILE_MAX_HZ 10000
+
+void profile_start (unsigned hz);
+void profile_sample (const struct intr_frame *);
+void profile_print (void);
+
+#endif /* threads/profile.h */
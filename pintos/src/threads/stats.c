@@ -0,0 +1,178 @@
+#include "threads/stats.h"
+#include <cpu.h>
+#include <debug.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Registered statistics.  Statically initialized so that
+   statistics can be registered before anything else is set up.
+   Entries are only ever appended, with interrupts off, so a
+   reader that walks a list forward always sees a well-formed
+   list. */
+static struct list counters = LIST_INITIALIZER (counters);
+static struct list hists = LIST_INITIALIZER (hists);
+
+/* Registers counter C under NAME, which must stay valid and must
+   not contain white space, and resets it to 0. */
+void
+stats_register_counter (struct stat_counter *c, const char *name)
+{
+  enum intr_level old_level;
+
+  ASSERT (c != NULL);
+  ASSERT (name != NULL && strchr (name, ' ') == NULL);
+
+  c->name = name;
+  c->value = 0;
+  old_level = intr_disable ();
+  list_push_back (&counters, &c->elem);
+  intr_set_level (old_level);
+}
+
+/* Registers histogram H under NAME, which must stay valid and
+   must not contain white space, and empties it. */
+void
+stats_register_hist (struct stat_hist *h, const char *name)
+{
+  enum intr_level old_level;
+
+  ASSERT (h != NULL);
+  ASSERT (name != NULL && strchr (name, ' ') == NULL);
+
+  h->name = name;
+  h->count = h->sum = h->min = h->max = 0;
+  memset (h->buckets, 0, sizeof h->buckets);
+  old_level = intr_disable ();
+  list_push_back (&hists, &h->elem);
+  intr_set_level (old_level);
+}
+
+/* Returns the histogram bucket for VALUE: 0 for 0, otherwise 1
+   plus the position of VALUE's most significant 1-bit. */
+static size_t
+bucket_of (uint64_t value)
+{
+  uint32_t hi = value >> 32;
+  uint32_t lo = value;
+  size_t bucket;
+
+  if (hi != 0)
+    bucket = 64 - __builtin_clz (hi);
+  else if (lo != 0)
+    bucket = 32 - __builtin_clz (lo);
+  else
+    bucket = 0;
+  return bucket < STAT_HIST_BUCKETS ? bucket : STAT_HIST_BUCKETS - 1;
+}
+
+/* Records VALUE in histogram H. */
+void
+stat_hist_add (struct stat_hist *h, uint64_t value)
+{
+  size_t bucket = bucket_of (value);
+  enum intr_level old_level = intr_disable ();
+
+  if (h->count == 0 || value < h->min)
+    h->min = value;
+  if (value > h->max)
+    h->max = value;
+  h->count++;
+  h->sum += value;
+  h->buckets[bucket]++;
+  intr_set_level (old_level);
+}
+
+/* Returns the number of CPU cycles since an arbitrary point in
+   the past, for timing short intervals, or 0 if the CPU cannot
+   count cycles. */
+uint64_t
+stats_clock (void)
+{
+  /* cpuid is slow, so only ask once. */
+  static int have_tsc = -1;
+
+  if (have_tsc < 0)
+    have_tsc = (cpu_features () & CPU_TSC) != 0;
+  return have_tsc ? rdtsc () : 0;
+}
+
+/* Returns *P, read with interrupts off so that an update cannot
+   change it halfway through. */
+static uint64_t
+read64 (const uint64_t *p)
+{
+  enum intr_level old_level = intr_disable ();
+  uint64_t value = *p;
+  intr_set_level (old_level);
+  return value;
+}
+
+/* Passes string S to EMIT. */
+static void
+emit_string (stats_emit_func *emit, void *aux, const char *s)
+{
+  emit (s, strlen (s), aux);
+}
+
+/* Passes a space followed by VALUE in decimal to EMIT. */
+static void
+emit_number (stats_emit_func *emit, void *aux, uint64_t value)
+{
+  char buf[24];
+  int length = snprintf (buf, sizeof buf, " %"PRIu64, value);
+  emit (buf, length, aux);
+}
+
+/* Passes the text of every registered statistic, in the format
+   described in stats.h, to EMIT, a piece at a time, with
+   auxiliary data AUX. */
+void
+stats_dump (stats_emit_func *emit, void *aux)
+{
+  struct list_elem *e;
+
+  for (e = list_begin (&counters); e != list_end (&counters);
+       e = list_next (e))
+    {
+      struct stat_counter *c = list_entry (e, struct stat_counter, elem);
+
+      emit_string (emit, aux, "counter ");
+      emit_string (emit, aux, c->name);
+      emit_number (emit, aux, read64 (&c->value));
+      emit_string (emit, aux, "\n");
+    }
+
+  for (e = list_begin (&hists); e != list_end (&hists); e = list_next (e))
+    {
+      struct stat_hist *h = list_entry (e, struct stat_hist, elem);
+      size_t bucket_cnt, i;
+
+      emit_string (emit, aux, "hist ");
+      emit_string (emit, aux, h->name);
+      emit_number (emit, aux, read64 (&h->count));
+      emit_number (emit, aux, read64 (&h->sum));
+      emit_number (emit, aux, read64 (&h->min));
+      emit_number (emit, aux, read64 (&h->max));
+      for (bucket_cnt = STAT_HIST_BUCKETS; bucket_cnt > 0; bucket_cnt--)
+        if (read64 (&h->buckets[bucket_cnt - 1]) != 0)
+          break;
+      for (i = 0; i < bucket_cnt; i++)
+        emit_number (emit, aux, read64 (&h->buckets[i]));
+      emit_string (emit, aux, "\n");
+    }
+}
+
+/* stats_emit_func for stats_print(). */
+static void
+print_text (const char *text, size_t length, void *aux UNUSED)
+{
+  printf ("%.*s", (int) length, text);
+}
+
+/* Prints every registered statistic to the console. */
+void
+stats_print (void)
+{
+  stats_dump (print_text, NULL);
+}
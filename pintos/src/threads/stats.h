@@ -0,0 +1,88 @@
+#ifndef THREADS_STATS_H
+#define THREADS_STATS_H
+
+#include <list.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "threads/interrupt.h"
+
+/* Kernel statistics registry.
+
+   A subsystem that wants to count something defines a
+   `struct stat_counter' or, to record a distribution such as a
+   latency, a `struct stat_hist', registers it under a name once
+   at initialization, and updates it with stat_inc(), stat_add(),
+   or stat_hist_add().  Updates are cheap enough for hot paths
+   and are safe in interrupt handlers.
+
+   stats_dump() reports every registered statistic, one per
+   line, counters first, each kind in registration order.  The
+   `stats' system call returns the same text to user programs,
+   and the kernel prints it at shutdown.  Each line has one of
+   these forms, with fields separated by single spaces:
+
+     counter NAME VALUE
+     hist NAME COUNT SUM MIN MAX B0 B1 ... Bn
+
+   NAME never contains white space.  All numbers are decimal.
+   For a histogram, COUNT values totalling SUM were recorded,
+   MIN and MAX are 0 if COUNT is 0, and bucket B0 counts the
+   values equal to 0 and bucket Bi, for i > 0, counts the values
+   V with 2**(i-1) <= V < 2**i.  Trailing empty buckets are
+   omitted.  Latencies are in CPU cycles, from stats_clock(). */
+
+/* A named 64-bit counter. */
+struct stat_counter
+  {
+    const char *name;           /* Name, e.g. "thread.switches". */
+    uint64_t value;             /* Current value. */
+    struct list_elem elem;      /* Element in registry. */
+  };
+
+/* Number of buckets in a histogram.  The last bucket also counts
+   everything too big for it. */
+#define STAT_HIST_BUCKETS 40
+
+/* A named histogram of 64-bit values. */
+struct stat_hist
+  {
+    const char *name;           /* Name, e.g. "syscall.read". */
+    uint64_t count;             /* Number of values recorded. */
+    uint64_t sum;               /* Sum of values recorded. */
+    uint64_t min, max;          /* Smallest and largest values. */
+    uint64_t buckets[STAT_HIST_BUCKETS];  /* Log2 buckets. */
+    struct list_elem elem;      /* Element in registry. */
+  };
+
+void stats_register_counter (struct stat_counter *, const char *name);
+void stats_register_hist (struct stat_hist *, const char *name);
+
+void stat_hist_add (struct stat_hist *, uint64_t value);
+uint64_t stats_clock (void);
+
+/* Receives each successive piece of output from stats_dump(). */
+typedef void stats_emit_func (const char *text, size_t length, void *aux);
+void stats_dump (stats_emit_func *, void *aux);
+void stats_print (void);
+
+/* Adds N to counter C. */
+static inline void
+stat_add (struct stat_counter *c, uint64_t n)
+{
+  /* A 64-bit add takes two instructions on x86, so an interrupt
+     handler updating the same counter could otherwise slip in
+     between them. */
+  enum intr_level old_level = intr_disable ();
+  c->value += n;
+  intr_set_level (old_level);
+}
+
+/* Adds 1 to counter C. */
+static inline void
+stat_inc (struct stat_counter *c)
+{
+  stat_add (c, 1);
+}
+
+#endif /* threads/stats.h */
@@ -27,10 +27,47 @@
 */
 
 #include "threads/synch.h"
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 #include "threads/interrupt.h"
+#include "threads/stats.h"
 #include "threads/thread.h"
+#include "threads/trace.h"
+
+/* One semaphore in a condition variable's waiter heap. */
+struct semaphore_elem
+  {
+    struct heap_elem elem;              /* Heap element. */
+    struct semaphore semaphore;         /* This semaphore. */
+    struct thread *thread;              /* Thread waiting on it. */
+    struct condition *cond;             /* Condition waited on. */
+  };
+
+static heap_less_func compare_sema_priority;
+static heap_less_func compare_cond_priority;
+
+/* Lock statistics. */
+static struct stat_counter lock_acquire_cnt;  /* Calls to lock_acquire(). */
+static struct stat_counter lock_contend_cnt;  /* ...that found it held. */
+static struct stat_hist lock_wait_hist;       /* Cycles those waited. */
+
+/* Locks profiled with lock_profile(), as `struct lock_stats'. */
+static struct list profiled_locks;
+
+static void lock_stats_acquired (struct lock_stats *, bool contended,
+                                 uint64_t wait_start);
+static void lock_stats_released (struct lock_stats *);
+
+/* Registers synchronization statistics. */
+void
+synch_init (void)
+{
+  stats_register_counter (&lock_acquire_cnt, "lock.acquires");
+  stats_register_counter (&lock_contend_cnt, "lock.contended");
+  stats_register_hist (&lock_wait_hist, "lock.wait");
+  list_init (&profiled_locks);
+}
 
 /* Initializes semaphore SEMA to VALUE.  A semaphore is a
    nonnegative integer along with two atomic operators for
@@ -48,7 +85,7 @@ sema_init (struct semaphore *sema, unsigned value)
   ASSERT (sema != NULL);
 
   sema->value = value;
-  list_init (&sema->waiters);
+  heap_init (&sema->waiters, compare_sema_priority, NULL);
 }
 
 /* Down or "P" operation on a semaphore.  Waits for SEMA's value
@@ -69,12 +106,9 @@ sema_down (struct semaphore *sema)
   old_level = intr_disable ();
   while (sema->value == 0)
     {
-		priority_donation();
-		list_insert_ordered(&sema->waiters, &thread_current()->elem, (list_less_func *) & compare_priority, NULL);
-        if(thread_mlfqs == false)
-		{
-			priority_donation();
-		}
+		struct thread *cur = thread_current();
+		cur->sema_wait = sema;
+		heap_insert(&sema->waiters, &cur->sema_elem);
 		thread_block();
     }
   sema->value--;
@@ -119,9 +153,12 @@ sema_up (struct semaphore *sema)
   ASSERT (sema != NULL);
 //  ASSERT (sema->value <= 2 && sema->value >= 0);
   old_level = intr_disable ();
-  if (!list_empty (&sema->waiters))
+  if (!heap_empty (&sema->waiters))
   {
-	    thread_unblock (list_entry (list_pop_front (&sema->waiters), struct thread, elem));
+	    struct thread *t = heap_entry (heap_pop_front (&sema->waiters),
+	                                   struct thread, sema_elem);
+	    t->sema_wait = NULL;
+	    thread_unblock (t);
   }
   sema->value++;
   if(!intr_context())
@@ -189,7 +226,9 @@ lock_init (struct lock *lock)
   ASSERT (lock != NULL);
 
   lock->holder = NULL;
+  lock->stats = NULL;
   sema_init (&lock->semaphore, 1);
+  heap_init (&lock->donors, compare_donor_priority, NULL);
 }
 
 /* Acquires LOCK, sleeping until it becomes available if
@@ -207,15 +246,46 @@ lock_acquire (struct lock *lock)
   ASSERT (!intr_context ());
   ASSERT (!lock_held_by_current_thread (lock));
 
+  struct thread *cur = thread_current ();
   enum intr_level old_level = intr_disable();
+  uint64_t wait_start = 0;
+  bool contended = lock->holder != NULL;
+  stat_inc(&lock_acquire_cnt);
+  if(contended)
+  {
+	stat_inc(&lock_contend_cnt);
+	trace(TRACE_LOCK_CONTEND, (uint32_t) lock, lock->holder->tid);
+	if(lock->stats != NULL)
+		strlcpy(lock->stats->owner, lock->holder->name,
+			sizeof lock->stats->owner);
+	wait_start = stats_clock();
+  }
   if((thread_mlfqs == false) && lock->holder)
   {
-	thread_current()->lock_wait = lock;
-	list_insert_ordered(&lock->holder->donate, &thread_current()->donation_thread, (list_less_func *) &compare_priority, NULL);
+	/* Join the lock's donor heap and push our priority down the
+	   chain of lock holders. */
+	cur->lock_wait = lock;
+	heap_insert(&lock->donors, &cur->donor_elem);
+	priority_donation();
   }
   sema_down (&lock->semaphore);
-  thread_current()->lock_wait = NULL;
-  lock->holder = thread_current ();
+  if(contended)
+	stat_hist_add(&lock_wait_hist, stats_clock() - wait_start);
+  if(cur->lock_wait != NULL)
+  {
+	heap_remove(&lock->donors, &cur->donor_elem);
+	cur->lock_wait = NULL;
+  }
+  lock->holder = cur;
+  trace(TRACE_LOCK_ACQUIRE, (uint32_t) lock, contended);
+  if(lock->stats != NULL)
+	lock_stats_acquired(lock->stats, contended, wait_start);
+  if(thread_mlfqs == false)
+  {
+	/* Threads still waiting for the lock now donate to us. */
+	heap_insert(&cur->held_locks, &lock->elem);
+	update_priority();
+  }
   intr_set_level(old_level);
 }
 
@@ -238,6 +308,13 @@ lock_try_acquire (struct lock *lock)
   if (success)
   {
     lock->holder = thread_current ();
+    if(lock->stats != NULL)
+      lock_stats_acquired(lock->stats, false, 0);
+    if(thread_mlfqs == false)
+    {
+      heap_insert(&thread_current()->held_locks, &lock->elem);
+      update_priority();
+    }
   }
   intr_set_level(old_level);
   return success;
@@ -256,9 +333,15 @@ lock_release (struct lock *lock)
 
   enum intr_level old_level = intr_disable();
   lock->holder = NULL;
-//must remove thread from donation list waiting for released lock
-  lock_removal(lock);
-  update_priority();
+  trace(TRACE_LOCK_RELEASE, (uint32_t) lock, 0);
+  if(lock->stats != NULL)
+	lock_stats_released(lock->stats);
+  //the lock's waiters stop donating to us once it is released
+  if(thread_mlfqs == false)
+  {
+	heap_remove(&thread_current()->held_locks, &lock->elem);
+	update_priority();
+  }
   sema_up (&lock->semaphore);
   intr_set_level(old_level);
 }
@@ -273,14 +356,108 @@ lock_held_by_current_thread (const struct lock *lock)
 
   return lock->holder == thread_current ();
 }
-
-/* One semaphore in a list. */
-struct semaphore_elem
-  {
-    struct list_elem elem;              /* List element. */
-    struct semaphore semaphore;         /* This semaphore. */
-  };
 
+/* Starts profiling contention for LOCK, recording it in STATS
+   under NAME, which must remain valid as long as the kernel
+   runs.  LOCK must not be held. */
+void
+lock_profile (struct lock *lock, struct lock_stats *stats, const char *name)
+{
+  enum intr_level old_level;
+
+  ASSERT (lock != NULL);
+  ASSERT (stats != NULL);
+  ASSERT (lock->holder == NULL);
+
+  memset (stats, 0, sizeof *stats);
+  stats->name = name;
+
+  old_level = intr_disable ();
+  list_push_back (&profiled_locks, &stats->elem);
+  lock->stats = stats;
+  intr_set_level (old_level);
+}
+
+/* Records in STATS that its lock was just acquired, after
+   waiting since WAIT_START if CONTENDED.  Interrupts must be
+   off. */
+static void
+lock_stats_acquired (struct lock_stats *stats, bool contended,
+                     uint64_t wait_start)
+{
+  uint64_t now = stats_clock ();
+
+  stats->acquires++;
+  if (contended)
+    {
+      uint64_t wait = now - wait_start;
+      stats->contended++;
+      stats->wait_total += wait;
+      if (wait > stats->wait_max)
+        stats->wait_max = wait;
+    }
+  stats->acquired_at = now;
+}
+
+/* Records in STATS that its lock is being released.  Interrupts
+   must be off. */
+static void
+lock_stats_released (struct lock_stats *stats)
+{
+  uint64_t hold = stats_clock () - stats->acquired_at;
+
+  stats->hold_total += hold;
+  if (hold > stats->hold_max)
+    stats->hold_max = hold;
+}
+
+/* Returns true if profiled lock A has waited less than B, so
+   that sorting puts the hottest locks last. */
+static bool
+lock_stats_cooler (const struct list_elem *a_, const struct list_elem *b_,
+                   void *aux UNUSED)
+{
+  const struct lock_stats *a = list_entry (a_, struct lock_stats, elem);
+  const struct lock_stats *b = list_entry (b_, struct lock_stats, elem);
+
+  if (a->wait_total != b->wait_total)
+    return a->wait_total < b->wait_total;
+  return a->contended < b->contended;
+}
+
+/* Prints the profiled locks, hottest first: those on which
+   threads spent the most time waiting. */
+void
+lock_stats_print (void)
+{
+  enum intr_level old_level;
+  struct list_elem *e;
+
+  if (list_empty (&profiled_locks))
+    return;
+
+  /* Sorting with interrupts off keeps the list stable, but the
+     numbers may still change as we print them. */
+  old_level = intr_disable ();
+  list_sort (&profiled_locks, lock_stats_cooler, NULL);
+  intr_set_level (old_level);
+
+  printf ("Lock contention, hottest first (times in cycles):\n");
+  printf ("%-16s %10s %10s %14s %12s %14s %12s  %s\n",
+          "lock", "acquires", "contended", "wait", "max wait",
+          "hold", "max hold", "last owner");
+  for (e = list_rbegin (&profiled_locks); e != list_rend (&profiled_locks);
+       e = list_prev (e))
+    {
+      struct lock_stats *s = list_entry (e, struct lock_stats, elem);
+      printf ("%-16s %10"PRIu64" %10"PRIu64" %14"PRIu64" %12"PRIu64
+              " %14"PRIu64" %12"PRIu64"  %s\n",
+              s->name, s->acquires, s->contended, s->wait_total,
+              s->wait_max, s->hold_total, s->hold_max,
+              s->contended > 0 ? s->owner : "-");
+    }
+}
+
 /* Initializes condition variable COND.  A condition variable
    allows one piece of code to signal a condition and cooperating
    code to receive the signal and act upon it. */
@@ -289,7 +466,7 @@ cond_init (struct condition *cond)
 {
   ASSERT (cond != NULL);
 
-  list_init (&cond->waiters);
+  heap_init (&cond->waiters, compare_cond_priority, NULL);
 }
 
 /* Atomically releases LOCK and waits for COND to be signaled by
@@ -316,6 +493,7 @@ void
 cond_wait (struct condition *cond, struct lock *lock)
 {
   struct semaphore_elem waiter;
+  enum intr_level old_level;
 
   ASSERT (cond != NULL);
   ASSERT (lock != NULL);
@@ -323,7 +501,12 @@ cond_wait (struct condition *cond, struct lock *lock)
   ASSERT (lock_held_by_current_thread (lock));
 
   sema_init (&waiter.semaphore, 0);
-  list_push_back (&cond->waiters, &waiter.elem);
+  waiter.thread = thread_current ();
+  waiter.cond = cond;
+  old_level = intr_disable ();
+  thread_current ()->cond_waiter = &waiter;
+  heap_insert (&cond->waiters, &waiter.elem);
+  intr_set_level (old_level);
   lock_release (lock);
   sema_down (&waiter.semaphore);
   lock_acquire (lock);
@@ -339,15 +522,24 @@ cond_wait (struct condition *cond, struct lock *lock)
 void
 cond_signal (struct condition *cond, struct lock *lock UNUSED)
 {
+  struct semaphore_elem *waiter = NULL;
+  enum intr_level old_level;
+
   ASSERT (cond != NULL);
   ASSERT (lock != NULL);
   ASSERT (!intr_context ());
   ASSERT (lock_held_by_current_thread (lock));
 
-  if (!list_empty (&cond->waiters))
+  old_level = intr_disable ();
+  if (!heap_empty (&cond->waiters))
   {
-	  sema_up (&list_entry (list_pop_front (&cond->waiters), struct semaphore_elem, elem)->semaphore);
+	  waiter = heap_entry (heap_pop_front (&cond->waiters),
+	                       struct semaphore_elem, elem);
+	  waiter->thread->cond_waiter = NULL;
   }
+  intr_set_level (old_level);
+  if (waiter != NULL)
+    sema_up (&waiter->semaphore);
 }
 
 /* Wakes up all threads, if any, waiting on COND (protected by
@@ -362,7 +554,140 @@ cond_broadcast (struct condition *cond, struct lock *lock)
   ASSERT (cond != NULL);
   ASSERT (lock != NULL);
 
-  while (!list_empty (&cond->waiters))
+  while (!heap_empty (&cond->waiters))
     cond_signal (cond, lock);
 }
 
+/* Initializes reader-writer lock RW. */
+void
+rwlock_init (struct rwlock *rw)
+{
+  ASSERT (rw != NULL);
+
+  rw->readers = 0;
+  lock_init (&rw->writer);
+  sema_init (&rw->drained, 0);
+}
+
+/* Acquires RW for reading, sleeping while a writer holds it or
+   is waiting for it.  While sleeping, this thread donates its
+   priority to that writer.
+
+   When no writer is around this costs no more than disabling
+   interrupts and bumping a counter.  This function may sleep, so
+   it must not be called within an interrupt handler. */
+void
+rwlock_acquire_read (struct rwlock *rw)
+{
+  enum intr_level old_level;
+
+  ASSERT (rw != NULL);
+  ASSERT (!intr_context ());
+
+  old_level = intr_disable ();
+  while (rw->writer.holder != NULL)
+    {
+      /* Wait for the writer by passing through its lock.
+         Releasing the lock may yield, so another writer may have
+         arrived by the time we look again. */
+      lock_acquire (&rw->writer);
+      lock_release (&rw->writer);
+    }
+  rw->readers++;
+  intr_set_level (old_level);
+}
+
+/* Releases RW, which the current thread must hold for reading.
+   Wakes a waiting writer if this was the last reader. */
+void
+rwlock_release_read (struct rwlock *rw)
+{
+  enum intr_level old_level;
+
+  ASSERT (rw != NULL);
+  ASSERT (rw->readers > 0);
+
+  old_level = intr_disable ();
+  if (--rw->readers == 0 && rw->writer.holder != NULL)
+    sema_up (&rw->drained);
+  intr_set_level (old_level);
+}
+
+/* Acquires RW for writing, sleeping until any other writer is
+   done and all active readers have left.  From the moment this
+   thread starts waiting, new readers wait for it.
+
+   Readers that are still draining out do not receive this
+   thread's priority, since there may be many of them; read-side
+   critical sections should be kept short.
+
+   This function may sleep, so it must not be called within an
+   interrupt handler. */
+void
+rwlock_acquire_write (struct rwlock *rw)
+{
+  enum intr_level old_level;
+
+  ASSERT (rw != NULL);
+  ASSERT (!intr_context ());
+
+  lock_acquire (&rw->writer);
+  old_level = intr_disable ();
+  while (rw->readers > 0)
+    sema_down (&rw->drained);
+  intr_set_level (old_level);
+}
+
+/* Releases RW, which the current thread must hold for writing. */
+void
+rwlock_release_write (struct rwlock *rw)
+{
+  ASSERT (rw != NULL);
+  ASSERT (rw->readers == 0);
+
+  lock_release (&rw->writer);
+}
+
+/* Returns true if the current thread holds RW for writing, false
+   otherwise.  Readers are not tracked individually. */
+bool
+rwlock_held_by_current_thread (const struct rwlock *rw)
+{
+  ASSERT (rw != NULL);
+
+  return lock_held_by_current_thread (&rw->writer);
+}
+
+/* Restores the ordering of the waiter heaps that blocked thread
+   T belongs to, after T's priority changed because of a
+   donation.  Must be called with interrupts off. */
+void
+synch_requeue (struct thread *t)
+{
+  ASSERT (intr_get_level () == INTR_OFF);
+
+  if (t->sema_wait != NULL)
+    heap_update (&t->sema_wait->waiters, &t->sema_elem);
+  if (t->cond_waiter != NULL)
+    heap_update (&t->cond_waiter->cond->waiters, &t->cond_waiter->elem);
+}
+
+/* Orders threads waiting on a semaphore by priority. */
+static bool
+compare_sema_priority (const struct heap_elem *a, const struct heap_elem *b,
+                       void *aux UNUSED)
+{
+  return (heap_entry (a, struct thread, sema_elem)->priority
+          < heap_entry (b, struct thread, sema_elem)->priority);
+}
+
+/* Orders the waiters on a condition variable by the priority of
+   the thread waiting on each one. */
+static bool
+compare_cond_priority (const struct heap_elem *a, const struct heap_elem *b,
+                       void *aux UNUSED)
+{
+  return (heap_entry (a, struct semaphore_elem, elem)->thread->priority
+          < heap_entry (b, struct semaphore_elem, elem)->thread->priority);
+}
+
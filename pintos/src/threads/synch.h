@@ -1,28 +1,37 @@
 #ifndef THREADS_SYNCH_H
 #define THREADS_SYNCH_H
 
+#include <heap.h>
 #include <list.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 /* A counting semaphore. */
 struct semaphore
   {
     unsigned value;             /* Current value. */
-    struct list waiters;        /* List of waiting threads. */
+    struct heap waiters;        /* Waiting threads, by priority. */
   };
 
+void synch_init (void);
+
 void sema_init (struct semaphore *, unsigned value);
 void sema_down (struct semaphore *);
 bool sema_try_down (struct semaphore *);
 void sema_up (struct semaphore *);
 void sema_self_test (void);
 
+struct thread;
+void synch_requeue (struct thread *);
+
 /* Lock. */
 struct lock
   {
     struct thread *holder;      /* Thread holding lock (for debugging). */
     struct semaphore semaphore; /* Binary semaphore controlling access. */
-//    struct list_elem elem;
+    struct heap donors;         /* Waiting threads, by priority. */
+    struct heap_elem elem;      /* Element in holder's held_locks. */
+    struct lock_stats *stats;   /* Contention profile, or null. */
   };
 
 void lock_init (struct lock *);
@@ -31,10 +40,35 @@ bool lock_try_acquire (struct lock *);
 void lock_release (struct lock *);
 bool lock_held_by_current_thread (const struct lock *);
 
+/* Contention profile of one lock.
+
+   Locks are not profiled by default.  To find out how much a
+   lock is fought over, give it a `struct lock_stats' of its own
+   with lock_profile().  lock_stats_print() then ranks it among
+   the other profiled locks, and the kernel does so at shutdown.
+   Times are in CPU cycles, from stats_clock(). */
+struct lock_stats
+  {
+    const char *name;           /* Name, e.g. "file_lock". */
+    uint64_t acquires;          /* Times acquired. */
+    uint64_t contended;         /* Times acquired after waiting. */
+    uint64_t wait_total;        /* Time spent waiting. */
+    uint64_t wait_max;          /* Longest wait. */
+    uint64_t hold_total;        /* Time held. */
+    uint64_t hold_max;          /* Longest hold. */
+    uint64_t acquired_at;       /* When the holder acquired it. */
+    char owner[16];             /* Holder that most recently made a
+                                   thread wait. */
+    struct list_elem elem;      /* Element in list of profiled locks. */
+  };
+
+void lock_profile (struct lock *, struct lock_stats *, const char *name);
+void lock_stats_print (void);
+
 /* Condition variable. */
 struct condition
   {
-    struct list waiters;        /* List of waiting threads. */
+    struct heap waiters;        /* Waiting threads, by priority. */
   };
 
 void cond_init (struct condition *);
@@ -42,6 +76,28 @@ void cond_wait (struct condition *, struct lock *);
 void cond_signal (struct condition *, struct lock *);
 void cond_broadcast (struct condition *, struct lock *);
 
+/* Reader-writer lock.
+
+   Any number of readers may hold the lock at once, or a single
+   writer.  Writers are preferred: once a writer is waiting, new
+   readers wait until it is done.  A writer holds `writer' for
+   its whole critical section, and readers or writers that must
+   wait for it block on `writer', so they donate their priority
+   to it just as they would to the holder of an ordinary lock. */
+struct rwlock
+  {
+    unsigned readers;           /* Number of active readers. */
+    struct lock writer;         /* Held by the active or pending writer. */
+    struct semaphore drained;   /* Upped when the last reader leaves. */
+  };
+
+void rwlock_init (struct rwlock *);
+void rwlock_acquire_read (struct rwlock *);
+void rwlock_release_read (struct rwlock *);
+void rwlock_acquire_write (struct rwlock *);
+void rwlock_release_write (struct rwlock *);
+bool rwlock_held_by_current_thread (const struct rwlock *);
+
 /* Optimization barrier.
 
    The compiler will not reorder operations across an
@@ -49,4 +105,64 @@ void cond_broadcast (struct condition *, struct lock *);
    reference guide for more information.*/
 #define barrier() asm volatile ("" : : : "memory")
 
+/* Sequence lock, for small values that are read far more often
+   than they are written, such as the timer tick count.
+
+   Readers never block or disable interrupts.  They take a
+   snapshot of the sequence number, read the protected data, and
+   retry if a write happened in the meantime:
+
+      unsigned seq;
+      do
+        {
+          seq = seqlock_read_begin (&sl);
+          ...copy the protected data...
+        }
+      while (seqlock_read_retry (&sl, seq));
+
+   Writers must not be preempted between seqlock_write_begin()
+   and seqlock_write_end(), so they must run in an interrupt
+   handler or with interrupts disabled. */
+struct seqlock
+  {
+    unsigned seq;               /* Odd while a write is in progress. */
+  };
+
+#define SEQLOCK_INITIALIZER { 0 }
+
+static inline void
+seqlock_init (struct seqlock *sl)
+{
+  sl->seq = 0;
+}
+
+static inline unsigned
+seqlock_read_begin (const struct seqlock *sl)
+{
+  unsigned seq = *(volatile const unsigned *) &sl->seq;
+  barrier ();
+  return seq;
+}
+
+static inline bool
+seqlock_read_retry (const struct seqlock *sl, unsigned seq)
+{
+  barrier ();
+  return (seq & 1) != 0 || *(volatile const unsigned *) &sl->seq != seq;
+}
+
+static inline void
+seqlock_write_begin (struct seqlock *sl)
+{
+  sl->seq++;
+  barrier ();
+}
+
+static inline void
+seqlock_write_end (struct seqlock *sl)
+{
+  barrier ();
+  sl->seq++;
+}
+
 #endif /* threads/synch.h */
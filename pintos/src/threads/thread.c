@@ -9,8 +9,10 @@
 #include "threads/intr-stubs.h"
 #include "threads/malloc.h"
 #include "threads/palloc.h"
+#include "threads/stats.h"
 #include "threads/switch.h"
 #include "threads/synch.h"
+#include "threads/trace.h"
 #include "threads/vaddr.h"
 #ifdef USERPROG
 #include "userprog/process.h"
@@ -39,6 +41,14 @@ static struct thread *initial_thread;
 /* Lock used by allocate_tid(). */
 static struct lock tid_lock;
 
+/* All threads, indexed by tid, so that a thread can be found
+   from its tid in constant time.  Threads are added when they
+   are created and removed when they start to exit. */
+static struct hash tid_table;
+static struct lock tid_table_lock;
+static hash_hash_func tid_hash;
+static hash_less_func tid_less;
+
 /* Stack frame for kernel_thread(). */
 struct kernel_thread_frame
   {
@@ -51,6 +61,7 @@ struct kernel_thread_frame
 static long long idle_ticks;    /* # of timer ticks spent idle. */
 static long long kernel_ticks;  /* # of timer ticks in kernel threads. */
 static long long user_ticks;    /* # of timer ticks in user programs. */
+static struct stat_counter switch_cnt; /* # of context switches. */
 
 /* Scheduling. */
 #define TIME_SLICE 4            /* # of timer ticks to give each thread. */
@@ -64,7 +75,6 @@ bool thread_mlfqs;
 static void kernel_thread (thread_func *, void *aux);
 
 static void idle (void *aux UNUSED);
-static struct thread *running_thread (void);
 static struct thread *next_thread_to_run (void);
 static void init_thread (struct thread *, const char *name, int priority);
 static bool is_thread (struct thread *) UNUSED;
@@ -72,6 +82,8 @@ static void *alloc_frame (struct thread *, size_t size);
 static void schedule (void);
 void thread_schedule_tail (struct thread *prev);
 static tid_t allocate_tid (void);
+static heap_less_func compare_lock_priority;
+static void thread_requeue (struct thread *);
 
 /* Initializes the threading system by transforming the code
    that's currently running into a thread.  This can't work in
@@ -94,8 +106,10 @@ thread_init (void)
   ASSERT (intr_get_level () == INTR_OFF);
 
   lock_init (&tid_lock);
+  lock_init (&tid_table_lock);
   list_init (&ready_list);
   list_init (&all_list);
+  stats_register_counter (&switch_cnt, "thread.switches");
 
   /* Set up a thread structure for the running thread. */
   initial_thread = running_thread ();
@@ -109,6 +123,15 @@ thread_init (void)
 void
 thread_start (void)
 {
+  /* Now that malloc() works, index the initial thread by tid. */
+  if (!hash_init (&tid_table, tid_hash, tid_less, NULL))
+    PANIC ("cannot allocate tid table");
+  hash_insert (&tid_table, &initial_thread->tid_elem);
+#ifdef USERPROG
+  if (!children_init (initial_thread))
+    PANIC ("cannot allocate child table");
+#endif
+
   /* Create the idle thread. */
   struct semaphore idle_started;
   sema_init (&idle_started, 0);
@@ -187,6 +210,7 @@ thread_create (const char *name, int priority,
   /* Initialize thread. */
   init_thread (t, name, priority);
   tid = t->tid = allocate_tid ();
+  trace_thread (tid, name);
 
   /* Prepare thread for first run by initializing its stack.
      Do this atomically so intermediate values for the 'stack'
@@ -210,9 +234,21 @@ thread_create (const char *name, int priority,
 
   intr_set_level (old_level);
 
+#ifdef USERPROG
   t->parent = thread_tid();
-  struct process_info *cp = add_child(t->tid);
-  t->cp = cp;
+  if (!children_init (t))
+    goto error;
+  t->cp = add_child(t->tid);
+  if (t->cp == NULL)
+    {
+      hash_destroy (&t->children, NULL);
+      goto error;
+    }
+#endif
+
+  lock_acquire (&tid_table_lock);
+  hash_insert (&tid_table, &t->tid_elem);
+  lock_release (&tid_table_lock);
 
   /* Add to run queue. */
   thread_unblock (t);
@@ -220,6 +256,15 @@ thread_create (const char *name, int priority,
   maximum_priority();
   intr_set_level(old_level);
   return tid;
+
+#ifdef USERPROG
+ error:
+  old_level = intr_disable ();
+  list_remove (&t->allelem);
+  intr_set_level (old_level);
+  palloc_free_page (t);
+  return TID_ERROR;
+#endif
 }
 
 /* Puts the current thread to sleep.  It will not be scheduled
@@ -234,6 +279,7 @@ thread_block (void)
   ASSERT (!intr_context ());
   ASSERT (intr_get_level () == INTR_OFF);
 
+  trace (TRACE_BLOCK, 0, 0);
   thread_current ()->status = THREAD_BLOCKED;
   schedule ();
 }
@@ -257,6 +303,7 @@ thread_unblock (struct thread *t)
   ASSERT (t->status == THREAD_BLOCKED);
   list_insert_ordered(&ready_list, &t->elem, (list_less_func *) &compare_priority, NULL);
   t->status = THREAD_READY;
+  trace (TRACE_UNBLOCK, t->tid, 0);
   intr_set_level (old_level);
 }
 
@@ -300,6 +347,10 @@ thread_exit (void)
 {
   ASSERT (!intr_context ());
 
+  lock_acquire (&tid_table_lock);
+  hash_delete (&tid_table, &thread_current ()->tid_elem);
+  lock_release (&tid_table_lock);
+
 #ifdef USERPROG
   process_exit ();
 #endif
@@ -467,7 +518,9 @@ kernel_thread (thread_func *function, void *aux)
   thread_exit ();       /* If function() returns, kill the thread. */
 }
 
-/* Returns the running thread. */
+/* Returns the running thread.  Unlike thread_current(), this
+   may be used while the running thread is in the middle of
+   changing its status, e.g. in schedule(). */
 struct thread *
 running_thread (void)
 {
@@ -508,13 +561,17 @@ init_thread (struct thread *t, const char *name, int priority)
   //initialize for priority donation
   t->initial_priority = priority;
   t->lock_wait = NULL;
-  list_init(&t->donate);
+  heap_init(&t->held_locks, compare_lock_priority, NULL);
 
   //initialize
   list_init(&t->filelist);
   t->fd = 2;
+  t->ioring = NULL;
+  t->stdout_buf = NULL;
+  t->stdout_len = 0;
 
-  list_init(&t->list_of_children);
+  list_init(&t->exited_children);
+  sema_init(&t->child_semaphore, 0);
   t->cp = NULL;
   t->parent = -1;
 }
@@ -611,7 +668,11 @@ schedule (void)
   ASSERT (is_thread (next));
 
   if (cur != next)
-    prev = switch_threads (cur, next);
+    {
+      stat_inc (&switch_cnt);
+      trace (TRACE_SWITCH, next->tid, cur->status);
+      prev = switch_threads (cur, next);
+    }
   thread_schedule_tail (prev);
 }
 
@@ -692,82 +753,125 @@ void maximum_priority(void)
 	}
 }
 
+/* Orders threads waiting for a lock by priority. */
+bool compare_donor_priority(const struct heap_elem *a, const struct heap_elem *b, void *aux UNUSED)
+{
+	struct thread *first_thread = heap_entry(a, struct thread, donor_elem);
+	struct thread *second_thread = heap_entry(b, struct thread, donor_elem);
+	return first_thread->priority < second_thread->priority;
+}
+
+/* Returns the priority that LOCK donates to its holder: that of
+   its highest-priority waiter, or PRI_MIN - 1 if it has none. */
+static int lock_priority(struct lock *lock)
+{
+	if(heap_empty(&lock->donors))
+	{
+		return PRI_MIN - 1;
+	}
+	return heap_entry(heap_front(&lock->donors), struct thread, donor_elem)->priority;
+}
+
+/* Orders the locks a thread holds by the priority they donate. */
+static bool compare_lock_priority(const struct heap_elem *a, const struct heap_elem *b, void *aux UNUSED)
+{
+	struct lock *first_lock = heap_entry(a, struct lock, elem);
+	struct lock *second_lock = heap_entry(b, struct lock, elem);
+	return lock_priority(first_lock) < lock_priority(second_lock);
+}
+
+/* Re-sorts T in the ready list, or in the semaphore or condition
+   it is waiting on, after its priority changed. */
+static void thread_requeue(struct thread *t)
+{
+	if(t->status == THREAD_READY)
+	{
+		list_remove(&t->elem);
+		list_insert_ordered(&ready_list, &t->elem, (list_less_func *) &compare_priority, NULL);
+	}
+	else if(t->status == THREAD_BLOCKED)
+	{
+		synch_requeue(t);
+	}
+}
+
+/* Propagates the running thread's priority along the chain of
+   locks it is waiting on.  Each lock keeps its waiters in a
+   max-heap and each holder keeps its locks in a max-heap keyed on
+   the lock's top waiter, so every step re-keys two heaps in
+   O(log n).  There is no limit on the depth of the chain; the
+   walk stops as soon as a holder already runs at least at the
+   donated priority.  Must be called with interrupts off. */
 void priority_donation(void)
 {
-	//we set a limit on depth of nested priority donations at 8 levels
-	//refrenced from pintos documatation
-	int current_depth = 0;
-	int limit = 8;
 	struct thread *current_thread = thread_current();
 	struct lock *current_lock = current_thread->lock_wait;
-	/* while (the depth and current threads wait_lock is less than the limit)
-	 * we check to see if the current thread has a lock, if not return
-	 * and if locked threads priority is >= current thread priority, return
-	 * after these conditions are checked we set the locked threads priority
-	 * to be that of the thread with the higher priority
-	 */
-	while(current_lock  && current_depth < limit)
+
+	ASSERT(intr_get_level() == INTR_OFF);
+	while(current_lock)
 	{
-		current_depth++;
-		if(!current_lock->holder)
+		struct thread *holder = current_lock->holder;
+		heap_update(&current_lock->donors, &current_thread->donor_elem);
+		if(!holder)
 		{
 			return;
 		}
-		if(current_lock->holder->priority >= current_thread->priority)
+		heap_update(&holder->held_locks, &current_lock->elem);
+		if(holder->priority >= current_thread->priority)
 		{
 			return;
 		}
-		current_lock->holder->priority = current_thread->priority;
-		current_thread = current_lock->holder;
+		holder->priority = current_thread->priority;
+		thread_requeue(holder);
+		current_thread = holder;
 		current_lock = current_thread->lock_wait;
 	}
 }
-void lock_removal(struct lock *lock)
-{
-	struct list_elem *current_element = list_begin(&thread_current()->donate);
-	struct list_elem *next_element;
-	/* We iterate through the list of threads to be donated
-	 * we donate to the next element in the list and remove current_element
-	 * from the front of the list*/
-	while(current_element != list_end(&thread_current()->donate))
-	{
-		struct thread *temp_thread = list_entry(current_element, struct thread, donation_thread);
-		next_element = list_next(current_element);
-		if(temp_thread->lock_wait == lock)
-		{
-			list_remove(current_element);
-		}
-		current_element = next_element;
-	}
-}
+
+/* Recomputes the running thread's priority as the greater of its
+   own priority and the priority donated by the locks it holds,
+   in O(1) from the top of its held_locks heap. */
 void update_priority(void)
 {
 	struct thread *current_thread = thread_current();
 	current_thread->priority = current_thread->initial_priority;
-	//if current_thread has an empty donation,return
-	if(list_empty(&current_thread->donate))
+	//if current_thread holds no locks, there are no donations
+	if(heap_empty(&current_thread->held_locks))
 	{
 		return;
 	}
-	struct thread *update_thread = list_entry(list_front(&current_thread->donate), struct thread, donation_thread);
-	//if the updated thread priority is greater, then update current threads priorty
-	if(update_thread->priority > current_thread->priority)
+	struct lock *top_lock = heap_entry(heap_front(&current_thread->held_locks), struct lock, elem);
+	//if the donated priority is greater, then update current threads priorty
+	if(lock_priority(top_lock) > current_thread->priority)
 	{
-		current_thread->priority = update_thread->priority;
+		current_thread->priority = lock_priority(top_lock);
 	}
 }
 /* END OF ADDED FUNCTIONS FOR PINTOS PROJECT PART 1 */
 //PROJECT 2 FUNCITONS
 bool thread_alive(int pid)
 {
-	struct list_elem *iterator;
-	for(iterator = list_begin(&all_list); 
-		iterator != list_end(&all_list);
-		iterator = list_next(iterator))
-	{
-		struct thread *entry = list_entry(iterator, struct thread,allelem);
-		if(entry->tid == pid)
-			return true;
-	}
-	return false;
+	struct thread key;
+	bool alive;
+	key.tid = pid;
+	lock_acquire(&tid_table_lock);
+	alive = hash_find(&tid_table, &key.tid_elem) != NULL;
+	lock_release(&tid_table_lock);
+	return alive;
+}
+
+/* Returns a hash of thread E's tid. */
+static unsigned
+tid_hash (const struct hash_elem *e, void *aux UNUSED)
+{
+  return hash_int (hash_entry (e, struct thread, tid_elem)->tid);
+}
+
+/* Returns true if thread A's tid is less than thread B's. */
+static bool
+tid_less (const struct hash_elem *a, const struct hash_elem *b,
+          void *aux UNUSED)
+{
+  return (hash_entry (a, struct thread, tid_elem)->tid
+          < hash_entry (b, struct thread, tid_elem)->tid);
 }
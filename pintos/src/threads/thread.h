@@ -2,8 +2,11 @@
 #define THREADS_THREAD_H
 
 #include <debug.h>
+#include <hash.h>
+#include <heap.h>
 #include <list.h>
 #include <stdint.h>
+#include "threads/synch.h"
 
 /* States in a thread's life cycle. */
 enum thread_status
@@ -75,11 +78,12 @@ typedef int tid_t;
    set to THREAD_MAGIC.  Stack overflow will normally change this
    value, triggering the assertion. */
 /* The `elem' member has a dual purpose.  It can be an element in
-   the run queue (thread.c), or it can be an element in a
-   semaphore wait list (synch.c).  It can be used these two ways
-   only because they are mutually exclusive: only a thread in the
+   the run queue (thread.c), or it can be an element in the
+   sleeping list (timer.c).  It can be used these two ways only
+   because they are mutually exclusive: only a thread in the
    ready state is on the run queue, whereas only a thread in the
-   blocked state is on a semaphore wait list. */
+   blocked state is on the sleeping list.  Semaphores keep their
+   waiters in a heap through `sema_elem' instead. */
 struct thread
   {
 	/* BEGINNING OF MODIFIED STRUCT FOR PINTOS PROJECT 1*/
@@ -90,8 +94,11 @@ struct thread
 	/*FOR PART 2 - PRIORITY SCHEDULING*/
 	int initial_priority;
 	struct lock *lock_wait;
-	struct list donate;
-	struct list_elem donation_thread;
+	struct heap held_locks;             /* Held locks, by top donor priority. */
+	struct heap_elem donor_elem;        /* Element in lock_wait's donors. */
+	struct semaphore *sema_wait;        /* Semaphore we are blocked on. */
+	struct heap_elem sema_elem;         /* Element in sema_wait's waiters. */
+	struct semaphore_elem *cond_waiter; /* Our entry in a condition, if any. */
 	/* END OF MODIFIED STRUCT FOR PINTOS PROJECT 1*/
 
     /* Owned by thread.c. */
@@ -101,6 +108,7 @@ struct thread
     uint8_t *stack;                     /* Saved stack pointer. */
     int priority;                       /* Priority. */
     struct list_elem allelem;           /* List element for all threads list. */
+    struct hash_elem tid_elem;          /* Element in tid table. */
 
 
     /* Shared between thread.c and synch.c. */
@@ -117,9 +125,14 @@ struct thread
     //FOR PROJECT 2
     struct list filelist;
     int fd;
+    struct ioring *ioring;              /* Registered I/O ring, if any. */
+    char *stdout_buf;                   /* Buffered console output, or null. */
+    size_t stdout_len;                  /* Bytes in stdout_buf. */
 
     //wait and exec syscalls
-    struct list list_of_children;
+    struct hash children;               /* Children's process_info, by pid. */
+    struct list exited_children;        /* Exited children not waited for. */
+    struct semaphore child_semaphore;   /* Upped whenever a child exits. */
     tid_t parent;
     struct process_info* cp;
     //end of additions from project 2
@@ -143,6 +156,7 @@ void thread_block (void);
 void thread_unblock (struct thread *);
 
 struct thread *thread_current (void);
+struct thread *running_thread (void);
 tid_t thread_tid (void);
 const char *thread_name (void);
 
@@ -168,9 +182,11 @@ bool compare_priority(const struct list_elem *a,
 bool compare_ticks(const struct list_elem *a,
 				   const struct list_elem *b,
 				   void *aux UNUSED);
+bool compare_donor_priority(const struct heap_elem *a,
+							const struct heap_elem *b,
+							void *aux UNUSED);
 void maximum_priority(void);
 void priority_donation(void);
-void lock_removal(struct lock *lock);
 void update_priority(void);
 
 /*END OF NEW FUNCTIONS FOR PINTOS PROJECT PART 1 */
@@ -0,0 +1,169 @@
+#include "threads/trace.h"
+#include <debug.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/interrupt.h"
+#include "threads/palloc.h"
+#include "threads/stats.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#ifdef FILESYS
+#include "filesys/file.h"
+#include "filesys/filesys.h"
+#endif
+
+/* Pages of memory for the event ring. */
+#define TRACE_PAGES 64
+
+/* True while events are being recorded. */
+bool trace_enabled;
+
+/* Event ring.  Events are written with interrupts off, so an
+   interrupt handler's events fall cleanly between those of the
+   code it interrupted. */
+static struct trace_event *events;  /* Ring, or null if not tracing. */
+static size_t event_cnt;            /* Number of slots in `events'. */
+static uint64_t event_total;        /* Events ever recorded. */
+
+/* Starts recording events.  Must be called after palloc_init(). */
+void
+trace_start (void)
+{
+  ASSERT (events == NULL);
+
+  event_cnt = TRACE_PAGES * PGSIZE / sizeof *events;
+  events = palloc_get_multiple (PAL_ASSERT | PAL_ZERO, TRACE_PAGES);
+  trace_enabled = true;
+  trace_thread (thread_tid (), thread_name ());
+}
+
+/* Records an event of the given TYPE with arguments A and B.
+   Use trace() instead, which skips the call when tracing is
+   off. */
+void
+trace_log (enum trace_type type, uint32_t a, uint32_t b)
+{
+  enum intr_level old_level;
+  struct trace_event *e;
+
+  old_level = intr_disable ();
+  if (trace_enabled)
+    {
+      e = &events[event_total++ % event_cnt];
+      e->time = stats_clock ();
+      e->tid = running_thread ()->tid;
+      e->type = type;
+      e->a = a;
+      e->b = b;
+    }
+  intr_set_level (old_level);
+}
+
+/* Records the creation of thread TID named NAME. */
+void
+trace_thread (int tid, const char *name)
+{
+  size_t len, ofs;
+
+  if (!trace_enabled)
+    return;
+
+  trace_log (TRACE_THREAD, tid, 0);
+  len = strlen (name) + 1;
+  for (ofs = 0; ofs < len; ofs += 4)
+    {
+      uint32_t chunk = 0;
+      memcpy (&chunk, name + ofs, len - ofs < 4 ? len - ofs : 4);
+      trace_log (TRACE_NAME, tid, chunk);
+    }
+}
+
+/* Stops recording events and returns the number of events in the
+   ring, storing the index in the ring of the oldest one in
+   *FIRST. */
+static size_t
+trace_stop (uint64_t *first)
+{
+  enum intr_level old_level = intr_disable ();
+  trace_enabled = false;
+  intr_set_level (old_level);
+
+  *first = event_total > event_cnt ? event_total - event_cnt : 0;
+  return event_total - *first;
+}
+
+/* Prints the events in the ring, oldest first, and stops
+   recording.  Prints a summary line, then one line per event:
+
+     TRACE TIME TID TYPE A B
+
+   with TIME, A, and B in hexadecimal and TID and TYPE in
+   decimal.  Does nothing if the events were already saved with
+   trace_save(). */
+void
+trace_print (void)
+{
+  uint64_t first, i;
+  size_t cnt;
+
+  if (events == NULL || !trace_enabled)
+    return;
+
+  cnt = trace_stop (&first);
+  printf ("Trace: %zu events, %"PRIu64" overwritten\n", cnt, first);
+  for (i = first; i < event_total; i++)
+    {
+      const struct trace_event *e = &events[i % event_cnt];
+      printf ("TRACE %016"PRIx64" %"PRId32" %"PRIu32" %"PRIx32" %"PRIx32"\n",
+              e->time, e->tid, e->type, e->a, e->b);
+    }
+}
+
+#ifdef FILESYS
+/* Writes the events in the ring, oldest first, to new file
+   ARGV[1] in the layout described in trace.h, and stops
+   recording, since writing the file would otherwise add events
+   to the ring as it is being written. */
+void
+trace_save (char **argv)
+{
+  const char *file_name = argv[1];
+  struct trace_header h;
+  struct file *file;
+  uint64_t first;
+  size_t cnt, head, tail;
+  off_t size;
+
+  if (events == NULL)
+    PANIC ("trace: tracing not enabled (use the -trace option)");
+
+  cnt = trace_stop (&first);
+  printf ("Saving %zu trace events to '%s'...\n", cnt, file_name);
+
+  /* The events are in two runs: from the oldest to the end of the
+     ring, then from the start of the ring to the newest. */
+  head = first % event_cnt;
+  tail = cnt - (cnt < event_cnt - head ? cnt : event_cnt - head);
+
+  h.magic = TRACE_MAGIC;
+  h.version = TRACE_VERSION;
+  h.event_size = sizeof *events;
+  h.count = cnt;
+  h.overwritten = first;
+
+  size = sizeof h + cnt * sizeof *events;
+  if (!filesys_create (file_name, size))
+    PANIC ("%s: create failed", file_name);
+  file = filesys_open (file_name);
+  if (file == NULL)
+    PANIC ("%s: open failed", file_name);
+  if (file_write (file, &h, sizeof h) != (off_t) sizeof h
+      || file_write (file, &events[head], (cnt - tail) * sizeof *events)
+         != (off_t) ((cnt - tail) * sizeof *events)
+      || file_write (file, events, tail * sizeof *events)
+         != (off_t) (tail * sizeof *events))
+    PANIC ("%s: write failed", file_name);
+  file_close (file);
+}
+#endif
@@ -0,0 +1,93 @@
+#ifndef THREADS_TRACE_H
+#define THREADS_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Kernel event tracing.
+
+   Once started by the "-trace" kernel command-line option, the
+   kernel records scheduler, synchronization, interrupt, disk,
+   and system call events into a ring of fixed-size binary
+   records, each stamped with the CPU cycle counter and the tid
+   of the running thread.  Recording an event only disables
+   interrupts for the few stores it takes, so unlike printf() it
+   takes no locks and does no I/O and barely disturbs the timing
+   being studied.  When the ring fills up, the oldest events are
+   overwritten.
+
+   The events can be saved to a file with the "trace FILE"
+   action, for extraction with "pintos -g FILE", and are otherwise
+   printed at shutdown.  utils/pintos-trace decodes either form
+   into a timeline. */
+
+/* Event types.  The meanings of the A and B arguments are given
+   for each type.  Values are part of the trace format, so add new
+   types only at the end. */
+enum trace_type
+  {
+    TRACE_THREAD,               /* Thread A created. */
+    TRACE_NAME,                 /* Next 4 bytes of thread A's name in B. */
+    TRACE_SWITCH,               /* Switch to thread A; B is old status. */
+    TRACE_BLOCK,                /* Running thread blocks. */
+    TRACE_UNBLOCK,              /* Thread A becomes ready. */
+    TRACE_LOCK_CONTEND,         /* Waits for lock A, held by thread B. */
+    TRACE_LOCK_ACQUIRE,         /* Acquired lock A; B is 1 if it waited. */
+    TRACE_LOCK_RELEASE,         /* Released lock A. */
+    TRACE_IRQ_ENTER,            /* External interrupt vector A begins. */
+    TRACE_IRQ_EXIT,             /* External interrupt vector A ends. */
+    TRACE_DISK_ISSUE,           /* Disk B issues request for sector A. */
+    TRACE_DISK_COMPLETE,        /* Disk B completes request for sector A. */
+    TRACE_SYSCALL_ENTER,        /* System call A begins. */
+    TRACE_SYSCALL_EXIT,         /* System call A returns B. */
+    TRACE_TYPE_CNT
+  };
+
+/* TRACE_THREAD is followed by TRACE_NAME events that spell out
+   the new thread's name, 4 bytes at a time, least significant
+   byte first, until one includes the null terminator.  For disk
+   events, B is 2 * channel + device, plus 0x100 for a write. */
+
+/* Binary trace file layout: a header, then `count' events,
+   oldest first.  All fields are little-endian. */
+#define TRACE_MAGIC 0x43525450  /* "PTRC". */
+#define TRACE_VERSION 1
+
+struct trace_header
+  {
+    uint32_t magic;             /* TRACE_MAGIC. */
+    uint32_t version;           /* TRACE_VERSION. */
+    uint32_t event_size;        /* sizeof (struct trace_event). */
+    uint32_t count;             /* Number of events that follow. */
+    uint64_t overwritten;       /* Events lost when the ring was full. */
+  };
+
+struct trace_event
+  {
+    uint64_t time;              /* CPU cycle counter. */
+    int32_t tid;                /* Running thread. */
+    uint32_t type;              /* A `enum trace_type'. */
+    uint32_t a, b;              /* Arguments. */
+  };
+
+/* True while events are being recorded. */
+extern bool trace_enabled;
+
+void trace_start (void);
+void trace_log (enum trace_type, uint32_t a, uint32_t b);
+void trace_thread (int tid, const char *name);
+void trace_print (void);
+#ifdef FILESYS
+void trace_save (char **argv);
+#endif
+
+/* Records an event of the given TYPE with arguments A and B, if
+   tracing is on. */
+static inline void
+trace (enum trace_type type, uint32_t a, uint32_t b)
+{
+  if (trace_enabled)
+    trace_log (type, a, b);
+}
+
+#endif /* threads/trace.h */
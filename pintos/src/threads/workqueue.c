@@ -0,0 +1,218 @@
+#include "threads/workqueue.h"
+#include <debug.h>
+#include <stdio.h>
+#include "threads/interrupt.h"
+#include "threads/thread.h"
+
+/* Kernel work queues.
+
+   Code that must not sleep, such as an interrupt handler, or
+   code that should not wait for a slow operation, can hand a
+   `struct work' to queue_work().  One of a fixed pool of worker
+   threads later runs it in an ordinary kernel thread context,
+   where it may sleep, take locks, and do I/O.
+
+   The pool is shared by all users, so nobody needs a thread (and
+   its page of memory) of their own for background work.  Items
+   that pile up while the workers are busy are run back to back,
+   so bursts of deferred work are naturally batched.
+
+   The queues are only touched with interrupts disabled, which is
+   what allows queue_work() to be called from interrupt
+   handlers. */
+
+/* Number of worker threads. */
+#define WORKER_CNT 2
+
+/* Pending work, one queue per priority. */
+static struct list queues[WORK_PRI_CNT];
+
+/* Number of items in all the queues. */
+static struct semaphore queued;
+
+static thread_func worker;
+
+/* Initializes the work queues and starts the worker threads.
+   Must be called after thread_start(). */
+void
+workqueue_init (void)
+{
+  int i;
+
+  for (i = 0; i < WORK_PRI_CNT; i++)
+    list_init (&queues[i]);
+  sema_init (&queued, 0);
+
+  for (i = 0; i < WORKER_CNT; i++)
+    {
+      char name[16];
+
+      snprintf (name, sizeof name, "worker %d", i);
+      if (thread_create (name, PRI_DEFAULT, worker, NULL) == TID_ERROR)
+        PANIC ("cannot create work queue thread");
+    }
+}
+
+/* Initializes W to run FUNC, which may use AUX, on the queue
+   for PRIORITY. */
+void
+work_init (struct work *w, work_func *func, void *aux,
+           enum work_priority priority)
+{
+  ASSERT (w != NULL);
+  ASSERT (func != NULL);
+  ASSERT (priority >= 0 && priority < WORK_PRI_CNT);
+
+  w->func = func;
+  w->aux = aux;
+  w->priority = priority;
+  w->pending = false;
+  w->running = false;
+  w->flushers = 0;
+  sema_init (&w->flushed, 0);
+}
+
+/* Adds W to its queue and wakes a worker to run it.  Interrupts
+   must be off. */
+static void
+enqueue_work (struct work *w)
+{
+  ASSERT (intr_get_level () == INTR_OFF);
+
+  list_push_back (&queues[w->priority], &w->elem);
+  sema_up (&queued);
+}
+
+/* Queues W to be run by a worker thread.  Returns true if W was
+   queued, false if it was already waiting in a queue.
+
+   If W is running, it is not put in a queue until that run
+   finishes, so that another worker cannot start a second run of
+   W alongside the first.
+
+   This function does not sleep, so it may be called from an
+   interrupt handler. */
+bool
+queue_work (struct work *w)
+{
+  enum intr_level old_level;
+  bool queued_now = false;
+
+  ASSERT (w != NULL);
+
+  old_level = intr_disable ();
+  if (!w->pending)
+    {
+      w->pending = true;
+      if (!w->running)
+        enqueue_work (w);
+      queued_now = true;
+    }
+  intr_set_level (old_level);
+
+  return queued_now;
+}
+
+/* Removes W from its queue if it has not started running yet.
+   Returns true if W was dequeued, false if it was not queued or
+   a worker is already on its way to take it.  Does not wait for
+   a run of W that has already started; use flush_work() for
+   that.
+
+   This function does not sleep, so it may be called from an
+   interrupt handler. */
+bool
+cancel_work (struct work *w)
+{
+  enum intr_level old_level;
+  bool cancelled = false;
+
+  ASSERT (w != NULL);
+
+  old_level = intr_disable ();
+  if (w->pending && w->running)
+    {
+      /* Waiting for its current run to finish, not in a queue. */
+      w->pending = false;
+      cancelled = true;
+    }
+  else if (w->pending && sema_try_down (&queued))
+    {
+      list_remove (&w->elem);
+      w->pending = false;
+      cancelled = true;
+      for (; w->flushers > 0; w->flushers--)
+        sema_up (&w->flushed);
+    }
+  intr_set_level (old_level);
+
+  return cancelled;
+}
+
+/* Waits until W is neither queued nor running.  If W keeps
+   queuing itself, this waits until it stops doing so.
+
+   This function may sleep, so it must not be called within an
+   interrupt handler. */
+void
+flush_work (struct work *w)
+{
+  enum intr_level old_level;
+
+  ASSERT (w != NULL);
+  ASSERT (!intr_context ());
+
+  old_level = intr_disable ();
+  if (w->pending || w->running)
+    {
+      w->flushers++;
+      sema_down (&w->flushed);
+    }
+  intr_set_level (old_level);
+}
+
+/* Removes and returns the oldest item in the highest-priority
+   nonempty queue.  Interrupts must be off and the queues must
+   not be empty. */
+static struct work *
+dequeue_work (void)
+{
+  int i;
+
+  ASSERT (intr_get_level () == INTR_OFF);
+
+  for (i = 0; i < WORK_PRI_CNT; i++)
+    if (!list_empty (&queues[i]))
+      return list_entry (list_pop_front (&queues[i]), struct work, elem);
+  NOT_REACHED ();
+}
+
+/* Worker thread.  Runs queued work items forever. */
+static void
+worker (void *aux UNUSED)
+{
+  for (;;)
+    {
+      enum intr_level old_level;
+      struct work *w;
+
+      sema_down (&queued);
+
+      old_level = intr_disable ();
+      w = dequeue_work ();
+      w->pending = false;
+      w->running = true;
+      intr_set_level (old_level);
+
+      w->func (w);
+
+      old_level = intr_disable ();
+      w->running = false;
+      if (w->pending)
+        enqueue_work (w);
+      else
+        for (; w->flushers > 0; w->flushers--)
+          sema_up (&w->flushed);
+      intr_set_level (old_level);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef THREADS_WORKQUEUE_H
+#define THREADS_WORKQUEUE_H
+
+#include <list.h>
+#include <stdbool.h>
+#include "threads/synch.h"
+
+/* Work queue priorities.  Workers always take the oldest item
+   from the highest-priority nonempty queue. */
+enum work_priority
+  {
+    WORK_HIGH,                  /* E.g. I/O completion. */
+    WORK_NORMAL,                /* Default. */
+    WORK_LOW,                   /* E.g. write-back, eviction. */
+    WORK_PRI_CNT                /* Number of priorities. */
+  };
+
+struct work;
+
+/* Function run by a worker thread for work item W. */
+typedef void work_func (struct work *w);
+
+/* A deferred piece of work.  Embed one in the structure that the
+   work operates on and use list_entry()-style arithmetic, or the
+   `aux' member, to get back to it from the work function.
+
+   A work item may be queued again once it has started running,
+   including by its own work function; the new run starts after
+   the current one finishes.  It must not be freed or
+   reinitialized while queued or running; use flush_work() to
+   wait for that. */
+struct work
+  {
+    struct list_elem elem;      /* Element in a work queue. */
+    work_func *func;            /* Function to run. */
+    void *aux;                  /* Auxiliary data for FUNC. */
+    enum work_priority priority; /* Queue to use. */
+    bool pending;               /* Queued, or to be queued once
+                                   the current run finishes? */
+    bool running;               /* Being run by a worker? */
+    unsigned flushers;          /* Threads waiting in flush_work(). */
+    struct semaphore flushed;   /* Upped once per flusher when idle. */
+  };
+
+void workqueue_init (void);
+void work_init (struct work *, work_func *, void *aux,
+                enum work_priority);
+bool queue_work (struct work *);
+bool cancel_work (struct work *);
+void flush_work (struct work *);
+
+#endif /* threads/workqueue.h */
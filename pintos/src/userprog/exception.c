@@ -3,11 +3,15 @@
 #include <stdio.h>
 #include <user/syscall.h>
 #include "userprog/gdt.h"
+#include "userprog/syscall.h"
+#include "userprog/uaccess.h"
 #include "threads/interrupt.h"
+#include "threads/stats.h"
 #include "threads/thread.h"
+#include "threads/vaddr.h"
 
 /* Number of page faults processed. */
-static long long page_fault_cnt;
+static struct stat_counter page_fault_cnt;
 
 static void kill (struct intr_frame *);
 static void page_fault (struct intr_frame *);
@@ -59,13 +63,15 @@ exception_init (void)
      We need to disable interrupts for page faults because the
      fault address is stored in CR2 and needs to be preserved. */
   intr_register_int (14, 0, INTR_OFF, page_fault, "#PF Page-Fault Exception");
+
+  stats_register_counter (&page_fault_cnt, "exception.page_faults");
 }
 
 /* Prints exception statistics. */
 void
 exception_print_stats (void) 
 {
-  printf ("Exception: %lld page faults\n", page_fault_cnt);
+  printf ("Exception: %"PRIu64" page faults\n", page_fault_cnt.value);
 }
 
 /* Handler for an exception (probably) caused by a user process. */
@@ -86,7 +92,9 @@ kill (struct intr_frame *f)
     {
     case SEL_UCSEG:
       /* User's code segment, so it's a user exception, as we
-         expected.  Kill the user process.  */
+         expected.  Kill the user process, after writing out
+         its own last output.  */
+      stdout_flush ();
       printf ("%s: dying due to interrupt %#04x (%s).\n",
               thread_name (), f->vec_no, intr_name (f->vec_no));
       intr_dump_frame (f);
@@ -143,16 +151,25 @@ page_fault (struct intr_frame *f)
   intr_enable ();
 
   /* Count page faults. */
-  page_fault_cnt++;
+  stat_inc (&page_fault_cnt);
 
   /* Determine cause. */
   not_present = (f->error_code & PF_P) == 0;
   write = (f->error_code & PF_W) != 0;
   user = (f->error_code & PF_U) != 0;
 
+  /* A kernel access to a user address is allowed only in the
+     functions in userprog/uaccess.c, which have a fixup for each
+     instruction that may fault.  Any other kernel fault is a bug
+     and panics below. */
+  if (!user && is_user_vaddr (fault_addr) && uaccess_fixup (f))
+    return;
+
   /* To implement virtual memory, delete the rest of the function
      body, and replace it with code that brings in the page to
      which fault_addr refers. */
+  if (user)
+    stdout_flush ();
   printf ("Page fault at %p: %s error %s page in %s context.\n",
           fault_addr,
           not_present ? "not present" : "rights violation",
@@ -0,0 +1,174 @@
+#include "userprog/pipe.h"
+#include <debug.h>
+#include <string.h>
+#include "threads/malloc.h"
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
+
+/* Pipes.
+
+   Each pipe buffers up to PIPE_SIZE bytes in a page of kernel
+   memory used as a ring.  A reader waits while the ring is empty
+   and a writer waits while it is full, so a producer and a
+   consumer stream data through memory at whatever rate the
+   slower of them allows.
+
+   Reading from a pipe whose write end is closed everywhere
+   returns what is left in it, then end of file.  Writing to a
+   pipe whose read end is closed everywhere fails. */
+
+#define PIPE_SIZE PGSIZE
+
+struct pipe
+  {
+    struct lock lock;           /* Protects all the members. */
+    struct condition not_empty; /* Signaled when data is added. */
+    struct condition not_full;  /* Signaled when data is removed. */
+    uint8_t *buf;               /* PIPE_SIZE-byte ring. */
+    unsigned head;              /* Total bytes ever written. */
+    unsigned tail;              /* Total bytes ever read. */
+    int readers;                /* Number of open read ends. */
+    int writers;                /* Number of open write ends. */
+  };
+
+/* Creates and returns a new, empty pipe with one read end and
+   one write end open, or a null pointer if memory is short. */
+struct pipe *
+pipe_create (void) 
+{
+  struct pipe *p = malloc (sizeof *p);
+  if (p == NULL)
+    return NULL;
+  p->buf = palloc_get_page (0);
+  if (p->buf == NULL)
+    {
+      free (p);
+      return NULL;
+    }
+
+  lock_init (&p->lock);
+  cond_init (&p->not_empty);
+  cond_init (&p->not_full);
+  p->head = p->tail = 0;
+  p->readers = p->writers = 1;
+  return p;
+}
+
+/* Opens another read end of P, or another write end if WRITER
+   is true. */
+void
+pipe_open (struct pipe *p, bool writer) 
+{
+  lock_acquire (&p->lock);
+  if (writer)
+    p->writers++;
+  else
+    p->readers++;
+  lock_release (&p->lock);
+}
+
+/* Closes a read end of P, or a write end if WRITER is true.
+   Frees P when no ends remain open. */
+void
+pipe_close (struct pipe *p, bool writer) 
+{
+  bool last;
+
+  lock_acquire (&p->lock);
+  if (writer)
+    {
+      ASSERT (p->writers > 0);
+      if (--p->writers == 0)
+        cond_broadcast (&p->not_empty, &p->lock);
+    }
+  else
+    {
+      ASSERT (p->readers > 0);
+      if (--p->readers == 0)
+        cond_broadcast (&p->not_full, &p->lock);
+    }
+  last = p->readers == 0 && p->writers == 0;
+  lock_release (&p->lock);
+
+  if (last)
+    {
+      palloc_free_page (p->buf);
+      free (p);
+    }
+}
+
+/* Reads up to SIZE bytes from P into BUFFER and returns the
+   number of bytes read.  If P is empty and WAIT is true, first
+   waits for data to be written or for the last write end to be
+   closed; otherwise, reads only what is already buffered.
+   Returns 0 at end of file. */
+int
+pipe_read (struct pipe *p, void *buffer_, size_t size, bool wait) 
+{
+  uint8_t *buffer = buffer_;
+  size_t copied = 0;
+
+  lock_acquire (&p->lock);
+  while (wait && size > 0 && p->head == p->tail && p->writers > 0)
+    cond_wait (&p->not_empty, &p->lock);
+
+  while (copied < size && p->head != p->tail)
+    {
+      size_t ofs = p->tail % PIPE_SIZE;
+      size_t chunk = p->head - p->tail;
+
+      if (chunk > PIPE_SIZE - ofs)
+        chunk = PIPE_SIZE - ofs;
+      if (chunk > size - copied)
+        chunk = size - copied;
+      memcpy (buffer + copied, p->buf + ofs, chunk);
+      p->tail += chunk;
+      copied += chunk;
+    }
+  if (copied > 0)
+    cond_broadcast (&p->not_full, &p->lock);
+  lock_release (&p->lock);
+
+  return copied;
+}
+
+/* Writes the SIZE bytes in BUFFER to P, waiting for room as
+   necessary.  Returns the number of bytes written, which is
+   less than SIZE only if the last read end is closed in the
+   meantime, or -1 if no read end was open to begin with. */
+int
+pipe_write (struct pipe *p, const void *buffer_, size_t size) 
+{
+  const uint8_t *buffer = buffer_;
+  size_t copied = 0;
+
+  lock_acquire (&p->lock);
+  if (p->readers == 0)
+    {
+      lock_release (&p->lock);
+      return -1;
+    }
+  while (copied < size && p->readers > 0)
+    {
+      size_t ofs = p->head % PIPE_SIZE;
+      size_t chunk = PIPE_SIZE - (p->head - p->tail);
+
+      if (chunk == 0)
+        {
+          cond_wait (&p->not_full, &p->lock);
+          continue;
+        }
+      if (chunk > PIPE_SIZE - ofs)
+        chunk = PIPE_SIZE - ofs;
+      if (chunk > size - copied)
+        chunk = size - copied;
+      memcpy (p->buf + ofs, buffer + copied, chunk);
+      p->head += chunk;
+      copied += chunk;
+      cond_broadcast (&p->not_empty, &p->lock);
+    }
+  lock_release (&p->lock);
+
+  return copied;
+}
@@ -0,0 +1,17 @@
+#ifndef USERPROG_PIPE_H
+#define USERPROG_PIPE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* A pipe: a one-page kernel buffer with a read end and a write
+   end, each of which may be open in any number of processes. */
+struct pipe;
+
+struct pipe *pipe_create (void);
+void pipe_open (struct pipe *, bool writer);
+void pipe_close (struct pipe *, bool writer);
+int pipe_read (struct pipe *, void *, size_t, bool wait);
+int pipe_write (struct pipe *, const void *, size_t);
+
+#endif /* userprog/pipe.h */
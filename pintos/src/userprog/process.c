@@ -11,6 +11,7 @@
 #include "filesys/directory.h"
 #include "filesys/file.h"
 #include "filesys/filesys.h"
+#include "filesys/inode.h"
 #include "threads/flags.h"
 #include "threads/init.h"
 #include "threads/interrupt.h"
@@ -24,6 +25,14 @@
 //struct process_info* get_proc(int pid);
 //void remove_child_process(int pid);
 
+/* What process_execute() hands to start_process(). */
+struct exec_info
+  {
+    char *cmd_line;             /* Copy of the command line, a page. */
+    struct list files;          /* Open files the process inherits. */
+    int fd;                     /* Next fd for the process to use. */
+  };
+
 static thread_func start_process NO_RETURN;
 static bool load (const char *cmdline, void (**eip) (void), void **esp,
 				  char** saveptr);
@@ -35,15 +44,33 @@ static bool load (const char *cmdline, void (**eip) (void), void **esp,
 tid_t
 process_execute (const char *file_name) 
 {
+  struct exec_info *exec;
   char *fn_copy;
   tid_t tid;
 
+  exec = malloc (sizeof *exec);
+  if (exec == NULL)
+    return TID_ERROR;
+
   /* Make a copy of FILE_NAME.
      Otherwise there's a race between the caller and load(). */
   fn_copy = palloc_get_page (0);
   if (fn_copy == NULL)
-    return TID_ERROR;
+    {
+      free (exec);
+      return TID_ERROR;
+    }
   strlcpy (fn_copy, file_name, PGSIZE);
+  exec->cmd_line = fn_copy;
+
+  /* Give the new process its own references to the caller's
+     pipe ends before it can run. */
+  if (!inherit_files (&exec->files, &exec->fd))
+    {
+      palloc_free_page (fn_copy);
+      free (exec);
+      return TID_ERROR;
+    }
 
 
   //parsed file name
@@ -51,21 +78,30 @@ process_execute (const char *file_name)
   file_name = strtok_r((char*) file_name, " ", &saveptr);
 
   /* Create a new thread to execute FILE_NAME. */
-  tid = thread_create (file_name, PRI_DEFAULT, start_process, fn_copy);
+  tid = thread_create (file_name, PRI_DEFAULT, start_process, exec);
   if (tid == TID_ERROR)
-    palloc_free_page (fn_copy); 
+    {
+      release_files (&exec->files);
+      palloc_free_page (fn_copy); 
+      free (exec);
+    }
   return tid;
 }
 
 /* A thread function that loads a user process and starts it
    running. */
 static void
-start_process (void *file_name_)
+start_process (void *exec_)
 {
-  char *file_name = file_name_;
+  struct exec_info *exec = exec_;
+  char *cmd_line = exec->cmd_line;
+  char *file_name = cmd_line;
   struct intr_frame if_;
   bool success;
 
+  adopt_files (&exec->files, exec->fd);
+  free (exec);
+
   //for gettting file name aka first parsed token
   char *saveptr;
   file_name = strtok_r(file_name, " ", &saveptr);
@@ -90,7 +126,7 @@ start_process (void *file_name_)
 
   sema_up(&thread_current()->cp->load_semaphore);
   /* If load failed, quit. */
-  palloc_free_page (file_name);
+  palloc_free_page (cmd_line);
   if (!success) 
     thread_exit ();
 
@@ -111,12 +147,11 @@ start_process (void *file_name_)
    been successfully called for the given TID, returns -1
    immediately, without waiting.
 
-   This function will be implemented in problem 2-2.  For now, it
-   does nothing. */
+   The parent sleeps on the child's exit_semaphore, which the
+   child ups from process_exit(), so waiting costs no CPU time. */
 int
-process_wait (tid_t child_tid UNUSED) 
+process_wait (tid_t child_tid) 
 {
-//  return -1;
   struct process_info *cp = get_child_process(child_tid);
   if(!cp)
   {
@@ -127,16 +162,55 @@ process_wait (tid_t child_tid UNUSED)
 	return -1;
   }
   cp->wait = true;
-  while(!cp->exit)
-  {
-	//lock_acquire(&cp->lock_wait);
-	barrier();
-  }
+  sema_down(&cp->exit_semaphore);
   int status = cp->status;
+  enum intr_level old_level = intr_disable();
+  list_remove(&cp->exit_elem);
+  intr_set_level(old_level);
   remove_child_process(cp);
   return status;
 }
 
+/* Waits for any child of the running process that has not yet
+   been waited for to die, reaps it, and returns its pid.  The
+   child's exit status is stored in *STATUS if STATUS is
+   non-null.  Returns -1 immediately if there is no such child.
+
+   Every exiting child puts itself on its parent's
+   exited_children list and ups the parent's child_semaphore, so
+   the parent sleeps until a child has exited and then finds it
+   without scanning its children. */
+tid_t
+process_wait_any (int *status)
+{
+  struct thread *cur = thread_current ();
+
+  for (;;)
+    {
+      struct process_info *cp = NULL;
+      enum intr_level old_level = intr_disable ();
+
+      if (!list_empty (&cur->exited_children))
+        cp = list_entry (list_pop_front (&cur->exited_children),
+                         struct process_info, exit_elem);
+      intr_set_level (old_level);
+
+      if (cp != NULL)
+        {
+          tid_t pid = cp->pid;
+          cp->wait = true;
+          sema_down (&cp->exit_semaphore);
+          if (status != NULL)
+            *status = cp->status;
+          remove_child_process (cp);
+          return pid;
+        }
+      if (hash_empty (&cur->children))
+        return -1;
+      sema_down (&cur->child_semaphore);
+    }
+}
+
 /* Free the current process's resources. */
 void
 process_exit (void)
@@ -150,10 +224,28 @@ process_exit (void)
 //  remove_child_process(CLOSE_ALL);
 	
   remove_child_proc();
-  if(thread_alive(cur->parent))
-  {
-	cur->cp->exit = true;
-  }
+
+  /* Wake up a parent blocked in process_wait() or
+     process_wait_any().  Interrupts stay off so that the parent
+     cannot exit between the check of cp->parent and the wakeup.
+     Then drop our reference to the process_info we share with
+     the parent. */
+  if (cur->cp != NULL)
+    {
+      struct process_info *cp = cur->cp;
+      enum intr_level old_level = intr_disable ();
+
+      cp->exit = true;
+      sema_up (&cp->exit_semaphore);
+      if (cp->parent != NULL)
+        {
+          list_push_back (&cp->parent->exited_children, &cp->exit_elem);
+          sema_up (&cp->parent->child_semaphore);
+        }
+      intr_set_level (old_level);
+      cur->cp = NULL;
+      release_child (cp);
+    }
   /* Destroy the current process's page directory and switch back
      to the kernel-only page directory. */
   pd = cur->pagedir;
@@ -251,12 +343,65 @@ struct Elf32_Phdr
 #define PF_W 2          /* Writable. */
 #define PF_R 4          /* Readable. */
 
+/* A loadable segment of an executable, as load_segment() takes
+   it. */
+struct load_seg
+  {
+    uint32_t file_page;         /* Page-aligned offset in file. */
+    uint32_t mem_page;          /* Page-aligned user virtual address. */
+    uint32_t read_bytes;        /* Bytes to read from file. */
+    uint32_t zero_bytes;        /* Bytes to zero after them. */
+    bool writable;              /* Map the pages writable? */
+  };
+
+/* An executable's parsed and validated ELF headers, in short
+   everything load() needs to know about it besides the contents
+   of its segments.
+
+   Images are cached, keyed by inode, so that a program that is
+   exec'd over and over is not opened, read, and checked from
+   scratch each time.  A cached image holds its inode open and
+   watches it with inode_watch(), so that the image is dropped,
+   and the inode closed, as soon as the executable is written or
+   removed. */
+struct exec_image
+  {
+    struct list_elem elem;      /* Element in image_cache. */
+    struct inode *inode;        /* Executable's inode. */
+    int ref_cnt;                /* Cache and loaders using this. */
+    Elf32_Addr entry;           /* Entry point. */
+    size_t seg_cnt;             /* Number of elements in segs. */
+    struct load_seg *segs;      /* Loadable segments. */
+  };
+
+/* Maximum number of images kept in the cache. */
+#define IMAGE_CACHE_SIZE 8
+
+/* Cached images, most recently used first. */
+static struct list image_cache;
+static size_t image_cnt;
+static struct lock image_lock;
+
+static struct exec_image *image_get (struct file *, const char *file_name);
+static void image_put (struct exec_image *);
+static void image_release (struct exec_image *);
+static void image_drop (struct exec_image *);
+static inode_watch_func image_changed;
+static struct exec_image *read_image (struct file *, const char *file_name);
 static bool setup_stack (void **esp, const char *filename, char** saveptr);
 static bool validate_segment (const struct Elf32_Phdr *, struct file *);
 static bool load_segment (struct file *file, off_t ofs, uint8_t *upage,
                           uint32_t read_bytes, uint32_t zero_bytes,
                           bool writable);
 
+/* Initializes the executable image cache. */
+void
+process_init (void) 
+{
+  list_init (&image_cache);
+  lock_init (&image_lock);
+}
+
 /* Loads an ELF executable from FILE_NAME into the current thread.
    Stores the executable's entry point into *EIP
    and its initial stack pointer into *ESP.
@@ -266,11 +411,10 @@ load (const char *file_name, void (**eip) (void), void **esp,
 	  char **saveptr) 
 {
   struct thread *t = thread_current ();
-  struct Elf32_Ehdr ehdr;
+  struct exec_image *image = NULL;
   struct file *file = NULL;
-  off_t file_ofs;
   bool success = false;
-  int i;
+  size_t i;
 
   /* Allocate and activate page directory. */
   t->pagedir = pagedir_create ();
@@ -286,7 +430,190 @@ load (const char *file_name, void (**eip) (void), void **esp,
       goto done; 
     }
 
+  /* Get its headers, from the cache if possible. */
+  image = image_get (file, file_name);
+  if (image == NULL)
+    goto done;
+
+  /* Load segments. */
+  for (i = 0; i < image->seg_cnt; i++) 
+    {
+      const struct load_seg *seg = &image->segs[i];
+      if (!load_segment (file, seg->file_page, (void *) seg->mem_page,
+                         seg->read_bytes, seg->zero_bytes, seg->writable))
+        goto done;
+    }
+
+  /* Set up stack. */
+  if (!setup_stack (esp, file_name, saveptr))
+    goto done;
+
+  /* Start address. */
+  *eip = (void (*) (void)) image->entry;
+
+  success = true;
+
+ done:
+  /* We arrive here whether the load is successful or not. */
+  if (image != NULL)
+    image_put (image);
+  file_close (file);
+  return success;
+}
+
+/* Returns the parsed headers of executable FILE, named FILE_NAME,
+   taken from the cache or else read from FILE and added to the
+   cache.  Returns a null pointer if FILE is not a valid
+   executable or memory is short.  The caller must release the
+   image with image_put(). */
+static struct exec_image *
+image_get (struct file *file, const char *file_name) 
+{
+  struct inode *inode = file_get_inode (file);
+  unsigned version = inode_version (inode);
+  struct exec_image *image;
+  struct list_elem *e;
+
+  /* Look for a cached image. */
+  lock_acquire (&image_lock);
+  for (e = list_begin (&image_cache); e != list_end (&image_cache);
+       e = list_next (e))
+    {
+      image = list_entry (e, struct exec_image, elem);
+      if (image->inode == inode)
+        {
+          list_remove (&image->elem);
+          list_push_front (&image_cache, &image->elem);
+          image->ref_cnt++;
+          lock_release (&image_lock);
+          return image;
+        }
+    }
+  lock_release (&image_lock);
+
+  /* Parse the headers without holding the lock, since that
+     involves reading from disk. */
+  image = read_image (file, file_name);
+  if (image == NULL)
+    return NULL;
+
+  /* Add the image to the cache, evicting the least recently used
+     image if the cache is full, unless another loader cached
+     FILE first or FILE changed in the meantime.  This relies on
+     inode_write_at() changing the version and calling the watch
+     both before and after it writes: a write that overlapped
+     read_image() either changed the version since we read it
+     above or, if it is still running, will call image_changed()
+     when it finishes.  The watch is set before the version is
+     checked, so that a write that the check misses still calls
+     image_changed(). */
+  lock_acquire (&image_lock);
+  for (e = list_begin (&image_cache); e != list_end (&image_cache);
+       e = list_next (e))
+    if (list_entry (e, struct exec_image, elem)->inode == inode)
+      break;
+  if (e == list_end (&image_cache))
+    {
+      inode_watch (inode, image_changed);
+      if (inode_version (inode) == version)
+        {
+          image->inode = inode_reopen (inode);
+          image->ref_cnt++;
+          list_push_front (&image_cache, &image->elem);
+          if (++image_cnt > IMAGE_CACHE_SIZE)
+            image_drop (list_entry (list_back (&image_cache),
+                                    struct exec_image, elem));
+        }
+      else
+        inode_watch (inode, NULL);
+    }
+  lock_release (&image_lock);
+  return image;
+}
+
+/* Removes IMAGE from the cache and releases the cache's
+   reference to it.  image_lock must be held. */
+static void
+image_drop (struct exec_image *image) 
+{
+  ASSERT (lock_held_by_current_thread (&image_lock));
+
+  list_remove (&image->elem);
+  image_cnt--;
+  inode_watch (image->inode, NULL);
+  image_release (image);
+}
+
+/* Called by the file system when INODE, the inode of a cached
+   image, is written or removed.  Drops the image at once, rather
+   than at the next exec, so that a removed executable's sectors
+   are freed as soon as nothing else has it open. */
+static void
+image_changed (struct inode *inode) 
+{
+  struct list_elem *e;
+
+  lock_acquire (&image_lock);
+  for (e = list_begin (&image_cache); e != list_end (&image_cache);
+       e = list_next (e))
+    {
+      struct exec_image *image = list_entry (e, struct exec_image, elem);
+      if (image->inode == inode)
+        {
+          image_drop (image);
+          break;
+        }
+    }
+  lock_release (&image_lock);
+}
+
+/* Releases a reference to IMAGE, freeing it if this was the last
+   one.  image_lock must be held. */
+static void
+image_release (struct exec_image *image) 
+{
+  ASSERT (lock_held_by_current_thread (&image_lock));
+
+  if (--image->ref_cnt == 0)
+    {
+      inode_close (image->inode);
+      free (image->segs);
+      free (image);
+    }
+}
+
+/* Releases a reference to IMAGE obtained from image_get(). */
+static void
+image_put (struct exec_image *image) 
+{
+  lock_acquire (&image_lock);
+  image_release (image);
+  lock_release (&image_lock);
+}
+
+/* Reads and verifies the ELF headers of executable FILE, named
+   FILE_NAME, and returns them as a new image with a single
+   reference that is not in the cache.  Returns a null pointer if
+   FILE is not a valid executable or memory is short. */
+static struct exec_image *
+read_image (struct file *file, const char *file_name) 
+{
+  struct exec_image *image;
+  struct Elf32_Ehdr ehdr;
+  size_t seg_max = 0;
+  off_t file_ofs;
+  int i;
+
+  image = malloc (sizeof *image);
+  if (image == NULL)
+    return NULL;
+  image->inode = NULL;
+  image->ref_cnt = 1;
+  image->seg_cnt = 0;
+  image->segs = NULL;
+
   /* Read and verify executable header. */
+  file_seek (file, 0);
   if (file_read (file, &ehdr, sizeof ehdr) != sizeof ehdr
       || memcmp (ehdr.e_ident, "\177ELF\1\1\1", 7)
       || ehdr.e_type != 2
@@ -296,8 +623,9 @@ load (const char *file_name, void (**eip) (void), void **esp,
       || ehdr.e_phnum > 1024) 
     {
       printf ("load: %s: error loading executable\n", file_name);
-      goto done; 
+      goto error; 
     }
+  image->entry = ehdr.e_entry;
 
   /* Read program headers. */
   file_ofs = ehdr.e_phoff;
@@ -306,11 +634,11 @@ load (const char *file_name, void (**eip) (void), void **esp,
       struct Elf32_Phdr phdr;
 
       if (file_ofs < 0 || file_ofs > file_length (file))
-        goto done;
+        goto error;
       file_seek (file, file_ofs);
 
       if (file_read (file, &phdr, sizeof phdr) != sizeof phdr)
-        goto done;
+        goto error;
       file_ofs += sizeof phdr;
       switch (phdr.p_type) 
         {
@@ -324,55 +652,58 @@ load (const char *file_name, void (**eip) (void), void **esp,
         case PT_DYNAMIC:
         case PT_INTERP:
         case PT_SHLIB:
-          goto done;
+          goto error;
         case PT_LOAD:
           if (validate_segment (&phdr, file)) 
             {
-              bool writable = (phdr.p_flags & PF_W) != 0;
-              uint32_t file_page = phdr.p_offset & ~PGMASK;
-              uint32_t mem_page = phdr.p_vaddr & ~PGMASK;
+              struct load_seg *seg;
               uint32_t page_offset = phdr.p_vaddr & PGMASK;
-              uint32_t read_bytes, zero_bytes;
+
+              if (image->seg_cnt >= seg_max)
+                {
+                  struct load_seg *segs;
+
+                  seg_max = seg_max ? seg_max * 2 : 4;
+                  segs = realloc (image->segs, seg_max * sizeof *segs);
+                  if (segs == NULL)
+                    goto error;
+                  image->segs = segs;
+                }
+              seg = &image->segs[image->seg_cnt++];
+              seg->writable = (phdr.p_flags & PF_W) != 0;
+              seg->file_page = phdr.p_offset & ~PGMASK;
+              seg->mem_page = phdr.p_vaddr & ~PGMASK;
               if (phdr.p_filesz > 0)
                 {
                   /* Normal segment.
                      Read initial part from disk and zero the rest. */
-                  read_bytes = page_offset + phdr.p_filesz;
-                  zero_bytes = (ROUND_UP (page_offset + phdr.p_memsz, PGSIZE)
-                                - read_bytes);
+                  seg->read_bytes = page_offset + phdr.p_filesz;
+                  seg->zero_bytes = (ROUND_UP (page_offset + phdr.p_memsz,
+                                               PGSIZE)
+                                     - seg->read_bytes);
                 }
               else 
                 {
                   /* Entirely zero.
                      Don't read anything from disk. */
-                  read_bytes = 0;
-                  zero_bytes = ROUND_UP (page_offset + phdr.p_memsz, PGSIZE);
+                  seg->read_bytes = 0;
+                  seg->zero_bytes = ROUND_UP (page_offset + phdr.p_memsz,
+                                              PGSIZE);
                 }
-              if (!load_segment (file, file_page, (void *) mem_page,
-                                 read_bytes, zero_bytes, writable))
-                goto done;
             }
           else
-            goto done;
+            goto error;
           break;
         }
     }
+  return image;
 
-  /* Set up stack. */
-  if (!setup_stack (esp, file_name, saveptr))
-    goto done;
-
-  /* Start address. */
-  *eip = (void (*) (void)) ehdr.e_entry;
-
-  success = true;
-
- done:
-  /* We arrive here whether the load is successful or not. */
-  file_close (file);
-  return success;
+ error:
+  free (image->segs);
+  free (image);
+  return NULL;
 }
-
+
 /* load() helpers. */
 
 static bool install_page (void *upage, void *kpage, bool writable);
@@ -1,5 +1,6 @@
 #include "userprog/syscall.h"
 #include <stdio.h>
+#include <string.h>
 #include <syscall-nr.h>
 #include <user/syscall.h>
 #include "threads/interrupt.h"
@@ -7,19 +8,74 @@
 #include "devices/input.h"
 #include "devices/shutdown.h"
 #include "userprog/process.h"
+#include "userprog/pipe.h"
 #include "threads/vaddr.h"
 #include "filesys/file.h"
 #include "filesys/filesys.h"
-#include "userprog/pagedir.h"
+#include "filesys/directory.h"
+#include "userprog/uaccess.h"
 #include "threads/malloc.h"
+#include "threads/palloc.h"
 #include "threads/synch.h"
+#include "threads/stats.h"
+#include "threads/trace.h"
 
 
 struct lock file_lock;
 //used for all file system syscalls
+static struct lock_stats file_lock_stats;
+//iovec arrays up to this size are copied onto the kernel stack
+#define IOV_SMALL 8
+//size of each process's console output buffer
+#define STDOUT_BUF_SIZE 512
+//number of system call numbers
+#define SYSCALL_CNT (SYS_DUP2 + 1)
+
+//per-system call counts and latencies, indexed by number
+static struct stat_hist syscall_stats[SYSCALL_CNT];
+static const char *syscall_names[SYSCALL_CNT] =
+{
+	[SYS_HALT] = "syscall.halt",
+	[SYS_EXIT] = "syscall.exit",
+	[SYS_EXEC] = "syscall.exec",
+	[SYS_WAIT] = "syscall.wait",
+	[SYS_CREATE] = "syscall.create",
+	[SYS_REMOVE] = "syscall.remove",
+	[SYS_OPEN] = "syscall.open",
+	[SYS_FILESIZE] = "syscall.filesize",
+	[SYS_READ] = "syscall.read",
+	[SYS_WRITE] = "syscall.write",
+	[SYS_SEEK] = "syscall.seek",
+	[SYS_TELL] = "syscall.tell",
+	[SYS_CLOSE] = "syscall.close",
+	[SYS_WAIT_ANY] = "syscall.wait_any",
+	[SYS_NULL] = "syscall.null",
+	[SYS_IORING_SETUP] = "syscall.ioring_setup",
+	[SYS_IORING_ENTER] = "syscall.ioring_enter",
+	[SYS_READV] = "syscall.readv",
+	[SYS_WRITEV] = "syscall.writev",
+	[SYS_PREAD] = "syscall.pread",
+	[SYS_PWRITE] = "syscall.pwrite",
+	[SYS_PIPE] = "syscall.pipe",
+	[SYS_EXEC_ASYNC] = "syscall.exec_async",
+	[SYS_EXEC_STATUS] = "syscall.exec_status",
+	[SYS_STATS] = "syscall.stats",
+	[SYS_DUP2] = "syscall.dup2",
+};
+
+//where stats() is copying the statistics to
+struct stats_copy
+{
+	char *buffer;		//user buffer
+	unsigned size;		//size of BUFFER
+	unsigned length;	//length of the text so far
+};
+
 struct file_proc
 {
-	struct file *file;
+	struct file *file;	//null for a pipe end
+	struct pipe *pipe;	//null for a file
+	bool writer;		//write end of the pipe?
 	int fd;
 	struct list_elem elem;
 };
@@ -30,7 +86,10 @@ struct file_proc
 void halt(void);
 void exit(int status);
 pid_t exec(const char *cmd_line);
+pid_t exec_async(const char *cmd_line);
+int exec_status(pid_t pid, bool wait);
 int wait(pid_t pid);
+pid_t wait_any(int *status);
 bool create(const char *file, unsigned initial_size);
 bool remove(const char *file);
 int open(const char *file);
@@ -40,15 +99,34 @@ int write(int fd, const void *buffer, unsigned size);
 void seek(int fd, unsigned position);
 unsigned tell(int fd);
 void close(int fd);
+bool ioring_setup(struct ioring *ring);
+int ioring_enter(void);
+int readv(int fd, const struct iovec *iov, int iovcnt);
+int writev(int fd, const struct iovec *iov, int iovcnt);
+int pread(int fd, void *buffer, unsigned size, unsigned offset);
+int pwrite(int fd, const void *buffer, unsigned size, unsigned offset);
+bool pipe(int fds[2]);
+int stats(char *buffer, unsigned size);
+int dup2(int oldfd, int newfd);
 //END OF SYSCALL FUNCTIONS
 
 int add_file(struct file *f);
 struct file* get_file(int fd);
+static int add_pipe(struct pipe *p, bool writer);
+static struct pipe *get_pipe(int fd, bool writer);
+static struct file_proc *get_fd(int fd);
+static bool is_console(int fd, int console_fd);
 void close_file(int fd);
 static void syscall_handler (struct intr_frame *);
-int user_kernel(const void *vaddr);
 void get_arguement(struct intr_frame *f, int *arg, int n);
-void check_validity(const void *vaddr);
+static bool get_string(char *dst, const char *ustr, size_t size);
+static int ioring_run(const struct ioring_sqe *sqe);
+static void stdout_write(const void *buffer, size_t size);
+void stdout_flush(void);
+static struct iovec *get_iovec(const struct iovec *uiov, int iovcnt,
+	struct iovec *small, bool write);
+static int transfer_iovec(struct file *file, const struct iovec *iov,
+	int iovcnt, off_t pos, bool reading);
 struct process_info* get_child_process(int pid);
 void remove_child_process(struct process_info *cp);
 
@@ -56,16 +134,37 @@ void remove_child_process(struct process_info *cp);
 void
 syscall_init (void) 
 {
+  int i;
+
   lock_init(&file_lock);
+  lock_profile(&file_lock, &file_lock_stats, "file_lock");
+  for (i = 0; i < SYSCALL_CNT; i++)
+    if (syscall_names[i] != NULL)
+      stats_register_hist (&syscall_stats[i], syscall_names[i]);
   intr_register_int (0x30, 3, INTR_ON, syscall_handler, "syscall");
 }
 
+/* Called by sysenter_entry in userprog/sysenter.S for a system
+   call made with SYSENTER.  F holds the user's segment registers,
+   eip, and esp, but not its general-purpose registers. */
+void
+syscall_sysenter (struct intr_frame *f)
+{
+	syscall_handler(f);
+}
+
 static void
 syscall_handler (struct intr_frame *f UNUSED) 
 {
-	int arg[3];
-	check_validity((const void*) f->esp);
-	switch (* (int *) f->esp)
+	int arg[4];
+	int number;
+	uint64_t start = stats_clock();
+	if(!copy_from_user(&number, f->esp, sizeof number))
+	{
+		exit(-1);
+	}
+	trace(TRACE_SYSCALL_ENTER, number, 0);
+	switch (number)
 	{
 		case SYS_HALT:
 			halt();
@@ -76,26 +175,26 @@ syscall_handler (struct intr_frame *f UNUSED)
 			break;
 		case SYS_EXEC:
 			get_arguement(f, &arg[0], 1);
-			arg[0] = user_kernel((const void *) arg[0]);
 			f->eax = exec((const char *) arg[0]);
 			break;
 		case SYS_WAIT:
 			get_arguement(f, &arg[0],1);
 			f->eax =wait(arg[0]);
 			break;
+		case SYS_WAIT_ANY:
+			get_arguement(f, &arg[0],1);
+			f->eax = wait_any((int *) arg[0]);
+			break;
 		case SYS_CREATE:
 			get_arguement(f, &arg[0],2);
-			arg[0] = user_kernel((const void *) arg[0]);
 			f->eax = create((const char *) arg[0], (unsigned) arg[1]);
 			break;
 		case SYS_REMOVE:
 			get_arguement(f, &arg[0],1);
-			arg[0] = user_kernel((const void *) arg[0]);
 			f->eax =remove((const char *) arg[0]);
 			break;
 		case SYS_OPEN:
 			get_arguement(f, &arg[0],1);
-			arg[0] = user_kernel((const void *) arg[0]);
 			f->eax =open((const char *) arg[0]);
 			break;
 		case SYS_FILESIZE:
@@ -104,12 +203,10 @@ syscall_handler (struct intr_frame *f UNUSED)
 			break;
 		case SYS_READ:
 			get_arguement(f, &arg[0],3);
-			arg[1] = user_kernel((const void *) arg[1]);
 			f->eax =read(arg[0], (void *) arg[1], (unsigned) arg[2]);
 			break;
 		case SYS_WRITE:
 			get_arguement(f, &arg[0],3);
-			arg[1] = user_kernel((const void *) arg[1]);
 			f->eax = write(arg[0], (const void *) arg[1], (unsigned) arg[2]);
 			break;
 		case SYS_SEEK:
@@ -124,19 +221,77 @@ syscall_handler (struct intr_frame *f UNUSED)
 			get_arguement(f,&arg[0],1);
 			close(arg[0]);
 			break;
+		case SYS_NULL:
+			f->eax = 0;
+			break;
+		case SYS_IORING_SETUP:
+			get_arguement(f, &arg[0], 1);
+			f->eax = ioring_setup((struct ioring *) arg[0]);
+			break;
+		case SYS_IORING_ENTER:
+			f->eax = ioring_enter();
+			break;
+		case SYS_READV:
+			get_arguement(f, &arg[0], 3);
+			f->eax = readv(arg[0], (const struct iovec *) arg[1], arg[2]);
+			break;
+		case SYS_WRITEV:
+			get_arguement(f, &arg[0], 3);
+			f->eax = writev(arg[0], (const struct iovec *) arg[1], arg[2]);
+			break;
+		case SYS_PREAD:
+			get_arguement(f, &arg[0], 4);
+			f->eax = pread(arg[0], (void *) arg[1], (unsigned) arg[2],
+				(unsigned) arg[3]);
+			break;
+		case SYS_PWRITE:
+			get_arguement(f, &arg[0], 4);
+			f->eax = pwrite(arg[0], (const void *) arg[1], (unsigned) arg[2],
+				(unsigned) arg[3]);
+			break;
+		case SYS_PIPE:
+			get_arguement(f, &arg[0], 1);
+			f->eax = pipe((int *) arg[0]);
+			break;
+		case SYS_EXEC_ASYNC:
+			get_arguement(f, &arg[0], 1);
+			f->eax = exec_async((const char *) arg[0]);
+			break;
+		case SYS_EXEC_STATUS:
+			get_arguement(f, &arg[0], 2);
+			f->eax = exec_status(arg[0], arg[1] != 0);
+			break;
+		case SYS_STATS:
+			get_arguement(f, &arg[0], 2);
+			f->eax = stats((char *) arg[0], arg[1]);
+			break;
+		case SYS_DUP2:
+			get_arguement(f, &arg[0], 2);
+			f->eax = dup2(arg[0], arg[1]);
+			break;
+	}
+	//calls that never return, such as exit, are not recorded
+	if(number >= 0 && number < SYSCALL_CNT && syscall_names[number] != NULL)
+	{
+		stat_hist_add(&syscall_stats[number], stats_clock() - start);
 	}
+	trace(TRACE_SYSCALL_EXIT, number, f->eax);
 }
 
 //---------------------------------
 void halt (void)
 {
+	stdout_flush();
 	shutdown_power_off();	
 }
 //---------------------------------
 void exit(int status)
 {
 	struct thread *current = thread_current();
-	if(thread_alive(current->parent))
+	stdout_flush();
+	free(current->stdout_buf);
+	current->stdout_buf = NULL;
+	if(current->cp)
 	{
 		current->cp->status = status;
 	}
@@ -146,45 +301,118 @@ void exit(int status)
 //---------------------------------
 pid_t exec(const char *cmd_line)
 {
-	pid_t pid = process_execute(cmd_line);
-	struct process_info* child_process = get_child_process(pid);
-	ASSERT(child_process);
-	if(child_process->load == 0)
+	pid_t pid = exec_async(cmd_line);
+	if(pid == -1 || exec_status(pid, true) != 1)
 	{
-		sema_down(&child_process->load_semaphore);
+		return -1;
+	}
+	return pid;
+}
+//---------------------------------
+//Starts a child process running CMD_LINE and returns its pid
+//without waiting for it to load its executable.  The result of
+//the load is available from exec_status().
+pid_t exec_async(const char *cmd_line)
+{
+	char *kcmd_line = palloc_get_page(0);
+	if(kcmd_line == NULL)
+	{
+		return -1;
+	}
+	if(!get_string(kcmd_line, cmd_line, PGSIZE))
+	{
+		palloc_free_page(kcmd_line);
+		return -1;
 	}
-	if(child_process->load == 2)
+	stdout_flush();
+	pid_t pid = process_execute(kcmd_line);
+	palloc_free_page(kcmd_line);
+	if(pid == TID_ERROR)
 	{
 		return -1;
-	}		
+	}
 	return pid;
 }
 //---------------------------------
+//Returns 1 if child PID has loaded its executable, -1 if loading
+//failed or PID is not a child that has yet to be waited for, or
+//0 if it is still loading.  If WAIT is true, waits for loading
+//to finish instead of returning 0.
+int exec_status(pid_t pid, bool wait)
+{
+	struct process_info* child_process = get_child_process(pid);
+	if(!child_process)
+	{
+		return -1;
+	}
+	if(child_process->load == 0)
+	{
+		if(!wait)
+		{
+			return 0;
+		}
+		sema_down(&child_process->load_semaphore);
+	}
+	return child_process->load == 1 ? 1 : -1;
+}
+//---------------------------------
 int wait(pid_t pid)
 {
+	stdout_flush();
 	return process_wait(pid);
 }
 //---------------------------------
+pid_t wait_any(int *status)
+{
+	int kstatus;
+	if(status != NULL && !user_writable(status, sizeof *status))
+	{
+		exit(-1);
+	}
+	stdout_flush();
+	pid_t pid = process_wait_any(&kstatus);
+	if(status != NULL && pid != -1)
+	{
+		*status = kstatus;
+	}
+	return pid;
+}
+//---------------------------------
 bool create(const char *file, unsigned initial_size)
 {
+	char name[NAME_MAX + 1];
+	if(!get_string(name, file, sizeof name))
+	{
+		return false;
+	}
 	lock_acquire(&file_lock);
-	bool noerror = filesys_create(file, initial_size);
+	bool noerror = filesys_create(name, initial_size);
 	lock_release(&file_lock);
 	return noerror;
 }
 //---------------------------------
 bool remove(const char *file)
 {
+	char name[NAME_MAX + 1];
+	if(!get_string(name, file, sizeof name))
+	{
+		return false;
+	}
 	lock_acquire(&file_lock);
-	bool noerror = filesys_remove(file);
+	bool noerror = filesys_remove(name);
 	lock_release(&file_lock);
 	return noerror;
 }
 //---------------------------------
 int open(const char *file)
 {
+	char name[NAME_MAX + 1];
+	if(!get_string(name, file, sizeof name))
+	{
+		return -1;
+	}
 	lock_acquire(&file_lock);
-	struct file *openfile = filesys_open(file);
+	struct file *openfile = filesys_open(name);
 	if(!openfile)
 	{
 		lock_release(&file_lock);
@@ -211,15 +439,22 @@ int filesize(int fd)
 //---------------------------------
 int read(int fd, void *buffer, unsigned size)
 {
-	if(fd == STDIN_FILENO)
+	if(!user_writable(buffer, size))
 	{
-		unsigned i;
-		uint8_t* buffer_local = (uint8_t *) buffer;
-		for(i = 0; i < size; i++)
-		{
-			buffer_local[i] = input_getc();
-		}
-		return size;
+		exit(-1);
+	}
+	if(is_console(fd, STDIN_FILENO))
+	{
+		//like a terminal, return whatever input is available,
+		//waiting only if there is none
+		stdout_flush();
+		return input_read(buffer, size, true);
+	}
+	struct pipe *readpipe = get_pipe(fd, false);
+	if(readpipe)
+	{
+		stdout_flush();
+		return pipe_read(readpipe, buffer, size, true);
 	}
 	lock_acquire(&file_lock);
 	struct file *readfile = get_file(fd);
@@ -235,11 +470,20 @@ int read(int fd, void *buffer, unsigned size)
 //---------------------------------
 int write(int fd, const void *buffer, unsigned size)
 {
-	if(fd == STDOUT_FILENO)
+	if(!user_readable(buffer, size))
 	{
-		putbuf(buffer, size);
+		exit(-1);
+	}
+	if(is_console(fd, STDOUT_FILENO))
+	{
+		stdout_write(buffer, size);
 		return size;
 	}
+	struct pipe *writepipe = get_pipe(fd, true);
+	if(writepipe)
+	{
+		return pipe_write(writepipe, buffer, size);
+	}
 	lock_acquire(&file_lock);
 	struct file *writefile = get_file(fd);
 	if(!writefile)
@@ -286,29 +530,537 @@ void close(int fd)
 	lock_release(&file_lock);
 }
 //---------------------------------
-void check_validity(const void *vaddr)
+//Registers RING, which lives in the process's own memory, for
+//ioring_enter(), or unregisters the current ring if RING is null.
+bool ioring_setup(struct ioring *ring)
+{
+	if(ring != NULL && !user_writable(ring, sizeof *ring))
+	{
+		return false;
+	}
+	thread_current()->ioring = ring;
+	return true;
+}
+//---------------------------------
+//Runs the requests queued in the current process's ring, taking
+//file_lock once for the whole batch.  Returns the number of
+//requests run, or -1 if no ring is registered.
+int ioring_enter(void)
 {
-	if(!is_user_vaddr(vaddr) || vaddr < 0x08048000)
+	struct ioring *ring = thread_current()->ioring;
+	unsigned sq_head, sq_tail, cq_head, cq_tail;
+	bool ok = true;
+	int done = 0;
+	if(ring == NULL)
+	{
+		return -1;
+	}
+	if(!copy_from_user(&sq_head, &ring->sq_head, sizeof sq_head)
+		|| !copy_from_user(&sq_tail, &ring->sq_tail, sizeof sq_tail)
+		|| !copy_from_user(&cq_head, &ring->cq_head, sizeof cq_head)
+		|| !copy_from_user(&cq_tail, &ring->cq_tail, sizeof cq_tail))
 	{
 		exit(-1);
 	}
+	lock_acquire(&file_lock);
+	while(sq_head != sq_tail && cq_tail - cq_head < IORING_ENTRIES)
+	{
+		struct ioring_sqe sqe;
+		struct ioring_cqe cqe;
+		if(!copy_from_user(&sqe, &ring->sq[sq_head % IORING_ENTRIES],
+			sizeof sqe))
+		{
+			ok = false;
+			break;
+		}
+		cqe.data = sqe.data;
+		cqe.result = ioring_run(&sqe);
+		if(!copy_to_user(&ring->cq[cq_tail % IORING_ENTRIES], &cqe,
+			sizeof cqe))
+		{
+			ok = false;
+			break;
+		}
+		sq_head++;
+		cq_tail++;
+		done++;
+	}
+	lock_release(&file_lock);
+	if(!ok
+		|| !copy_to_user(&ring->sq_head, &sq_head, sizeof sq_head)
+		|| !copy_to_user(&ring->cq_tail, &cq_tail, sizeof cq_tail))
+	{
+		exit(-1);
+	}
+	return done;
 }
 //---------------------------------
-//ADDIDTIONAL FUCNTIONS
-int user_kernel(const void *vaddr)
+//Runs a single ring request.  file_lock must be held.
+static int ioring_run(const struct ioring_sqe *sqe)
+{
+	struct file *file;
+	switch(sqe->op)
+	{
+		case IORING_NOP:
+			return 0;
+		case IORING_READ:
+		case IORING_WRITE:
+			if(sqe->op == IORING_READ
+				? !user_writable(sqe->buffer, sqe->size)
+				: !user_readable(sqe->buffer, sqe->size))
+			{
+				return -1;
+			}
+			if(sqe->op == IORING_WRITE
+				&& is_console(sqe->fd, STDOUT_FILENO))
+			{
+				stdout_write(sqe->buffer, sqe->size);
+				return sqe->size;
+			}
+			file = get_file(sqe->fd);
+			if(!file)
+			{
+				return -1;
+			}
+			if(sqe->op == IORING_READ)
+			{
+				return sqe->offset < 0
+					? file_read(file, sqe->buffer, sqe->size)
+					: file_read_at(file, sqe->buffer, sqe->size, sqe->offset);
+			}
+			return sqe->offset < 0
+				? file_write(file, sqe->buffer, sqe->size)
+				: file_write_at(file, sqe->buffer, sqe->size, sqe->offset);
+		case IORING_SEEK:
+			file = get_file(sqe->fd);
+			if(!file || sqe->offset < 0)
+			{
+				return -1;
+			}
+			file_seek(file, sqe->offset);
+			return 0;
+	}
+	return -1;
+}
+//---------------------------------
+//Writes SIZE bytes from BUFFER to the console on behalf of the
+//current process.  Output is collected in a per-process buffer
+//and handed to the console a line at a time, so that a program
+//writing many small pieces takes the console lock once per line
+//instead of once per write, and its lines are not broken up by
+//other processes' output.  Writes at least as large as the
+//buffer go straight to the console.
+static void stdout_write(const void *buffer, size_t size)
+{
+	struct thread *current = thread_current();
+	if(current->stdout_buf == NULL && size < STDOUT_BUF_SIZE)
+	{
+		current->stdout_buf = malloc(STDOUT_BUF_SIZE);
+	}
+	if(current->stdout_buf == NULL || size >= STDOUT_BUF_SIZE)
+	{
+		stdout_flush();
+		putbuf(buffer, size);
+		return;
+	}
+	if(size > STDOUT_BUF_SIZE - current->stdout_len)
+	{
+		stdout_flush();
+	}
+	memcpy(current->stdout_buf + current->stdout_len, buffer, size);
+	current->stdout_len += size;
+	if(memchr(buffer, '\n', size) != NULL
+		|| current->stdout_len == STDOUT_BUF_SIZE)
+	{
+		stdout_flush();
+	}
+}
+//---------------------------------
+//Writes any console output buffered by stdout_write().  Called
+//before the process exits or halts the machine, before the kernel
+//reports that it is being killed, and before it waits for input
+//or for another process, so that its output appears in order.
+void stdout_flush(void)
+{
+	struct thread *current = thread_current();
+	if(current->stdout_len > 0)
+	{
+		putbuf(current->stdout_buf, current->stdout_len);
+		current->stdout_len = 0;
+	}
+}
+//---------------------------------
+//Reads from FD into each of the IOVCNT buffers in IOV in turn,
+//starting at the file's current position.
+int readv(int fd, const struct iovec *uiov, int iovcnt)
+{
+	struct iovec small[IOV_SMALL];
+	struct iovec *iov;
+	int bytes = -1;
+	if(iovcnt < 0 || iovcnt > IOV_MAX)
+	{
+		return -1;
+	}
+	iov = get_iovec(uiov, iovcnt, small, true);
+	if(iov == NULL)
+	{
+		return -1;
+	}
+	if(is_console(fd, STDIN_FILENO))
+	{
+		int i;
+		bytes = 0;
+		stdout_flush();
+		for(i = 0; i < iovcnt; i++)
+		{
+			size_t n = input_read(iov[i].iov_base, iov[i].iov_len,
+				bytes == 0);
+			bytes += n;
+			if(n < iov[i].iov_len)
+			{
+				break;
+			}
+		}
+	}
+	else if(get_pipe(fd, false))
+	{
+		struct pipe *readpipe = get_pipe(fd, false);
+		int i;
+		bytes = 0;
+		stdout_flush();
+		for(i = 0; i < iovcnt; i++)
+		{
+			int n = pipe_read(readpipe, iov[i].iov_base, iov[i].iov_len,
+				bytes == 0);
+			bytes += n;
+			if((size_t) n < iov[i].iov_len)
+			{
+				break;
+			}
+		}
+	}
+	else
+	{
+		lock_acquire(&file_lock);
+		struct file *readfile = get_file(fd);
+		if(readfile)
+		{
+			off_t pos = file_tell(readfile);
+			bytes = transfer_iovec(readfile, iov, iovcnt, pos, true);
+			file_seek(readfile, pos + bytes);
+		}
+		lock_release(&file_lock);
+	}
+	if(iov != small)
+	{
+		free(iov);
+	}
+	return bytes;
+}
+//---------------------------------
+//Writes each of the IOVCNT buffers in IOV to FD in turn,
+//starting at the file's current position.
+int writev(int fd, const struct iovec *uiov, int iovcnt)
+{
+	struct iovec small[IOV_SMALL];
+	struct iovec *iov;
+	int bytes = -1;
+	if(iovcnt < 0 || iovcnt > IOV_MAX)
+	{
+		return -1;
+	}
+	iov = get_iovec(uiov, iovcnt, small, false);
+	if(iov == NULL)
+	{
+		return -1;
+	}
+	if(is_console(fd, STDOUT_FILENO))
+	{
+		int i;
+		bytes = 0;
+		for(i = 0; i < iovcnt; i++)
+		{
+			stdout_write(iov[i].iov_base, iov[i].iov_len);
+			bytes += iov[i].iov_len;
+		}
+	}
+	else if(get_pipe(fd, true))
+	{
+		struct pipe *writepipe = get_pipe(fd, true);
+		int i;
+		bytes = 0;
+		for(i = 0; i < iovcnt; i++)
+		{
+			int n = pipe_write(writepipe, iov[i].iov_base, iov[i].iov_len);
+			if(n < 0)
+			{
+				bytes = bytes > 0 ? bytes : -1;
+				break;
+			}
+			bytes += n;
+			if((size_t) n < iov[i].iov_len)
+			{
+				break;
+			}
+		}
+	}
+	else
+	{
+		lock_acquire(&file_lock);
+		struct file *writefile = get_file(fd);
+		if(writefile)
+		{
+			off_t pos = file_tell(writefile);
+			bytes = transfer_iovec(writefile, iov, iovcnt, pos, false);
+			file_seek(writefile, pos + bytes);
+		}
+		lock_release(&file_lock);
+	}
+	if(iov != small)
+	{
+		free(iov);
+	}
+	return bytes;
+}
+//---------------------------------
+//Reads from FD at OFFSET without using or moving the file's
+//position.
+int pread(int fd, void *buffer, unsigned size, unsigned offset)
+{
+	if(!user_writable(buffer, size))
+	{
+		exit(-1);
+	}
+	lock_acquire(&file_lock);
+	struct file *readfile = get_file(fd);
+	if(!readfile)
+	{
+		lock_release(&file_lock);
+		return -1;
+	}
+	int bytes = file_read_at(readfile, buffer, size, offset);
+	lock_release(&file_lock);
+	return bytes;
+}
+//---------------------------------
+//Writes to FD at OFFSET without using or moving the file's
+//position.
+int pwrite(int fd, const void *buffer, unsigned size, unsigned offset)
+{
+	if(!user_readable(buffer, size))
+	{
+		exit(-1);
+	}
+	lock_acquire(&file_lock);
+	struct file *writefile = get_file(fd);
+	if(!writefile)
+	{
+		lock_release(&file_lock);
+		return -1;
+	}
+	int bytes = file_write_at(writefile, buffer, size, offset);
+	lock_release(&file_lock);
+	return bytes;
+}
+//---------------------------------
+//Copies the IOVCNT-element array UIOV into kernel memory, using
+//SMALL if IOVCNT is at most IOV_SMALL, and checks that each of
+//its buffers is user memory, writable if WRITE is true.  Kills
+//the process if not.  Returns the copy, which the caller must
+//free() if it is not SMALL, or a null pointer if out of memory.
+static struct iovec *get_iovec(const struct iovec *uiov, int iovcnt,
+	struct iovec *small, bool write)
+{
+	struct iovec *iov = small;
+	bool ok;
+	int i;
+	if(iovcnt > IOV_SMALL)
+	{
+		iov = malloc(iovcnt * sizeof *iov);
+		if(iov == NULL)
+		{
+			return NULL;
+		}
+	}
+	ok = copy_from_user(iov, uiov, iovcnt * sizeof *iov);
+	for(i = 0; ok && i < iovcnt; i++)
+	{
+		ok = write ? user_writable(iov[i].iov_base, iov[i].iov_len)
+			: user_readable(iov[i].iov_base, iov[i].iov_len);
+	}
+	if(!ok)
+	{
+		if(iov != small)
+		{
+			free(iov);
+		}
+		exit(-1);
+	}
+	return iov;
+}
+//---------------------------------
+//Reads into or writes from the IOVCNT buffers in IOV, starting
+//at POS in FILE, until a transfer comes up short.  Returns the
+//number of bytes transferred.  file_lock must be held.
+static int transfer_iovec(struct file *file, const struct iovec *iov,
+	int iovcnt, off_t pos, bool reading)
+{
+	int i, total = 0;
+	for(i = 0; i < iovcnt; i++)
+	{
+		off_t bytes = reading
+			? file_read_at(file, iov[i].iov_base, iov[i].iov_len, pos + total)
+			: file_write_at(file, iov[i].iov_base, iov[i].iov_len, pos + total);
+		total += bytes;
+		if(bytes != (off_t) iov[i].iov_len)
+		{
+			break;
+		}
+	}
+	return total;
+}
+//---------------------------------
+//Copies the user string USTR into the SIZE bytes at DST.  Kills
+//the process if USTR is not valid user memory.  Returns false if
+//the string, with its null terminator, does not fit.
+static bool get_string(char *dst, const char *ustr, size_t size)
+{
+	int length = strncpy_from_user(dst, ustr, size);
+	if(length < 0)
+	{
+		exit(-1);
+	}
+	return (size_t) length < size;
+}
+//---------------------------------
+//Creates a pipe and stores the file descriptors for its read and
+//write ends in FDS[0] and FDS[1].  Both ends are inherited by
+//processes started with exec().
+bool pipe(int fds[2])
+{
+	int kfds[2];
+	if(!user_writable(fds, sizeof kfds))
+	{
+		exit(-1);
+	}
+	struct pipe *p = pipe_create();
+	if(!p)
+	{
+		return false;
+	}
+	kfds[0] = add_pipe(p, false);
+	kfds[1] = add_pipe(p, true);
+	if(kfds[0] < 0 || kfds[1] < 0)
+	{
+		int i;
+		for(i = 0; i < 2; i++)
+		{
+			if(kfds[i] < 0)
+			{
+				pipe_close(p, i == 1);
+			}
+			else
+			{
+				close(kfds[i]);
+			}
+		}
+		return false;
+	}
+	copy_to_user(fds, kfds, sizeof kfds);
+	return true;
+}
+//---------------------------------
+//Copies as much of TEXT as still fits to the user buffer in AUX,
+//a struct stats_copy.
+static void stats_copy(const char *text, size_t length, void *aux)
 {
-	check_validity(vaddr);	
-	void *ukptr = pagedir_get_page(thread_current()->pagedir, vaddr);
-	if(!ukptr)
+	struct stats_copy *c = aux;
+	if(c->length < c->size)
+	{
+		size_t n = c->size - c->length;
+		if(n > length)
+		{
+			n = length;
+		}
+		copy_to_user(c->buffer + c->length, text, n);
+	}
+	c->length += length;
+}
+//---------------------------------
+//Copies the kernel statistics, in the text format described in
+//threads/stats.h, to BUFFER, which holds SIZE bytes.  Returns the
+//length of the whole text, which is more than SIZE if it did not
+//all fit.  No null terminator is written.
+int stats(char *buffer, unsigned size)
+{
+	struct stats_copy c;
+	if(!user_writable(buffer, size))
 	{
 		exit(-1);
 	}
-	return (int) ukptr;
+	c.buffer = buffer;
+	c.size = size;
+	c.length = 0;
+	stats_dump(stats_copy, &c);
+	return c.length;
+}
+//---------------------------------
+//Makes NEWFD refer to what OLDFD refers to, closing NEWFD first if
+//it is open, and returns NEWFD, or -1 if OLDFD is not open or
+//NEWFD is negative.  A pipe end is shared between the two fds.  A
+//file is reopened, so each fd has its own position.  Pointing fd
+//0 or 1 at a pipe end this way redirects the process's standard
+//input or output, and that of processes it then starts with
+//exec(); closing the fd switches it back to the console.
+int dup2(int oldfd, int newfd)
+{
+	struct thread *current = thread_current();
+	if(newfd < 0)
+	{
+		return -1;
+	}
+	lock_acquire(&file_lock);
+	struct file_proc *old = get_fd(oldfd);
+	if(!old || oldfd == newfd)
+	{
+		lock_release(&file_lock);
+		return old ? newfd : -1;
+	}
+	struct file_proc *copy = malloc(sizeof *copy);
+	if(!copy)
+	{
+		lock_release(&file_lock);
+		return -1;
+	}
+	*copy = *old;
+	if(old->pipe)
+	{
+		pipe_open(old->pipe, old->writer);
+	}
+	else if((copy->file = file_reopen(old->file)) == NULL)
+	{
+		free(copy);
+		lock_release(&file_lock);
+		return -1;
+	}
+	close_file(newfd);
+	copy->fd = newfd;
+	list_push_back(&current->filelist, &copy->elem);
+	if(newfd >= current->fd)
+	{
+		current->fd = newfd + 1;
+	}
+	lock_release(&file_lock);
+	return newfd;
 }
+//---------------------------------
+//ADDIDTIONAL FUCNTIONS
 int add_file(struct file *f)
 {
 	struct file_proc *addthis = malloc(sizeof(struct file_proc));
 	addthis->file = f;
+	addthis->pipe = NULL;
+	addthis->writer = false;
 	addthis->fd = thread_current()->fd;
 	thread_current()->fd++;
 	list_push_back(&thread_current()->filelist, &addthis->elem);
@@ -328,6 +1080,125 @@ struct file* get_file(int fd)
 	}
 	return NULL;
 }
+//Adds an fd for the read end of pipe P, or the write end if
+//WRITER is true, taking over a reference to that end.  Returns
+//the new fd, or -1 if memory is short.
+static int add_pipe(struct pipe *p, bool writer)
+{
+	struct file_proc *addthis = malloc(sizeof(struct file_proc));
+	if(!addthis)
+	{
+		return -1;
+	}
+	addthis->file = NULL;
+	addthis->pipe = p;
+	addthis->writer = writer;
+	addthis->fd = thread_current()->fd;
+	thread_current()->fd++;
+	list_push_back(&thread_current()->filelist, &addthis->elem);
+	return addthis->fd;
+}
+//Returns the pipe whose read end, or write end if WRITER is true,
+//is open as FD, or a null pointer if FD is not such a pipe end.
+static struct pipe *get_pipe(int fd, bool writer)
+{
+	struct thread *current = thread_current();
+	struct list_elem *i;
+	for(i = list_begin(&current->filelist); 
+		i != list_end(&current->filelist); 
+		i = list_next(i))
+	{
+		struct file_proc *fp = list_entry(i, struct file_proc, elem);
+		if(fd == fp->fd)
+			return fp->pipe && fp->writer == writer ? fp->pipe : NULL;
+	}
+	return NULL;
+}
+//Returns FD's entry in the current process's fd table, or a null
+//pointer if FD is not open.
+static struct file_proc *get_fd(int fd)
+{
+	struct thread *current = thread_current();
+	struct list_elem *i;
+	for(i = list_begin(&current->filelist); 
+		i != list_end(&current->filelist); 
+		i = list_next(i))
+	{
+		struct file_proc *fp = list_entry(i, struct file_proc, elem);
+		if(fd == fp->fd)
+			return fp;
+	}
+	return NULL;
+}
+//Returns true if FD is CONSOLE_FD, STDIN_FILENO or STDOUT_FILENO,
+//and has not been redirected with dup2(), so that it still means
+//the console.
+static bool is_console(int fd, int console_fd)
+{
+	return fd == console_fd && get_fd(fd) == NULL;
+}
+//Copies each pipe end that the current process has open into
+//FILES, taking a reference to each, for a process that it is
+//about to start with exec().  Stores the next fd for that process
+//to use in *FD.  Returns false, with FILES empty, if memory is
+//short.
+bool inherit_files(struct list *files, int *fd)
+{
+	struct thread *current = thread_current();
+	struct list_elem *i;
+	list_init(files);
+	for(i = list_begin(&current->filelist); 
+		i != list_end(&current->filelist); 
+		i = list_next(i))
+	{
+		struct file_proc *fp = list_entry(i, struct file_proc, elem);
+		if(fp->pipe)
+		{
+			struct file_proc *copy = malloc(sizeof *copy);
+			if(!copy)
+			{
+				release_files(files);
+				return false;
+			}
+			*copy = *fp;
+			pipe_open(fp->pipe, fp->writer);
+			list_push_back(files, &copy->elem);
+		}
+	}
+	*fd = current->fd;
+	return true;
+}
+//Makes FILES and FD, from inherit_files(), the current process's
+//open files and its next fd.  Called by the new process before
+//it loads its executable.
+void adopt_files(struct list *files, int fd)
+{
+	struct thread *current = thread_current();
+	while(!list_empty(files))
+	{
+		list_push_back(&current->filelist, list_pop_front(files));
+	}
+	current->fd = fd;
+}
+//Closes and frees each entry in FILES, from inherit_files(), when
+//the process they were meant for is not started after all.
+void release_files(struct list *files)
+{
+	while(!list_empty(files))
+	{
+		struct file_proc *fp = list_entry(list_pop_front(files),
+			struct file_proc, elem);
+		if(fp->pipe)
+		{
+			pipe_close(fp->pipe, fp->writer);
+		}
+		else
+		{
+			file_close(fp->file);
+		}
+		free(fp);
+	}
+}
 void close_file(int fd)
 {
 	struct thread *current = thread_current();
@@ -338,7 +1209,14 @@ void close_file(int fd)
 		struct file_proc *pf = list_entry(e, struct file_proc, elem);
 		if(fd == pf->fd || fd == -1)
 		{
-			file_close(pf->file);
+			if(pf->pipe)
+			{
+				pipe_close(pf->pipe, pf->writer);
+			}
+			else
+			{
+				file_close(pf->file);
+			}
 			list_remove(&pf->elem);
 			free(pf);
 			if(fd != -1)
@@ -350,66 +1228,97 @@ void close_file(int fd)
 	}
 }
 //---------------------------------
+//Each thread keeps its children's process_info in a hash table
+//keyed by pid, so that finding a child costs the same however
+//many children there are.
+static unsigned child_hash(const struct hash_elem *e, void *aux UNUSED)
+{
+	return hash_int(hash_entry(e, struct process_info, elem)->pid);
+}
+static bool child_less(const struct hash_elem *a, const struct hash_elem *b,
+	void *aux UNUSED)
+{
+	return hash_entry(a, struct process_info, elem)->pid
+		< hash_entry(b, struct process_info, elem)->pid;
+}
+//Initializes T's table of children.  Returns false if memory is
+//short.
+bool children_init(struct thread *t)
+{
+	return hash_init(&t->children, child_hash, child_less, NULL);
+}
+//---------------------------------
 struct process_info* get_child_process(int pid)
 {
-	struct thread *current = thread_current();
-	struct list_elem *e;
-	for(e = list_begin (&current->list_of_children);
-		e != list_end(&current->list_of_children);
-		e = list_next(e))
-	{
-		struct process_info *cp = list_entry (e, struct process_info, elem);
-		if(pid == cp->pid)
-		{
-			return cp;
-		}
-	}
-	return NULL;
+	struct process_info key;
+	struct hash_elem *e;
+	key.pid = pid;
+	e = hash_find(&thread_current()->children, &key.elem);
+	return e ? hash_entry(e, struct process_info, elem) : NULL;
 }
 //---------------------------------
+//Forgets about child CP, which has been waited for.
 void remove_child_process(struct process_info *cp)
 {
-	list_remove(&cp->elem);
-	free(cp);
+	hash_delete(&thread_current()->children, &cp->elem);
+	release_child(cp);
 }
 //---------------------------------
+//Creates the process_info shared between the current thread and
+//its new child PID.  Returns a null pointer if memory is short.
 struct process_info* add_child(int pid)
 {
 	struct process_info* child = malloc(sizeof(struct process_info));
+	if(!child)
+	{
+		return NULL;
+	}
 	child->pid = pid;
 	child->load = 0;
 	child->wait = false;
 	child->exit = false;
+	child->status = -1;
+	child->ref_cnt = 2;
+	child->parent = thread_current();
 	sema_init(&child->load_semaphore,0);
 	sema_init(&child->exit_semaphore,0);
-	list_push_back(&thread_current()->list_of_children, &child->elem);
+	hash_insert(&thread_current()->children, &child->elem);
 	return child;
 }
 //---------------------------------
-void remove_child_proc(void)
+//Drops a reference to CP, freeing it if that was the last one.
+void release_child(struct process_info *cp)
 {
-	struct thread *curr = thread_current();
-	struct list_elem *next = list_begin(&curr->list_of_children);
-	struct list_elem *i = list_begin(&curr->list_of_children);
-	while(i != list_end(&curr->list_of_children))
+	enum intr_level old_level = intr_disable();
+	bool last = --cp->ref_cnt == 0;
+	intr_set_level(old_level);
+	if(last)
 	{
-		next = list_next(i);
-		struct process_info *cp = list_entry(i, struct process_info, elem);
-		list_remove(&cp->elem);
 		free(cp);
-		i = next;
 	}
 }
 //---------------------------------
+//Tells child E that its parent is exiting and drops the parent's
+//reference to it.
+static void orphan_child(struct hash_elem *e, void *aux UNUSED)
+{
+	struct process_info *cp = hash_entry(e, struct process_info, elem);
+	enum intr_level old_level = intr_disable();
+	cp->parent = NULL;
+	intr_set_level(old_level);
+	release_child(cp);
+}
+//---------------------------------
+void remove_child_proc(void)
+{
+	hash_destroy(&thread_current()->children, orphan_child);
+}
+//---------------------------------
 void get_arguement(struct intr_frame *f, int *arg, int n)
 {
-	int i;
-	int *ptr;
-	for(i=0; i < n; i++)
+	if(!copy_from_user(arg, (int *) f->esp + 1, n * sizeof *arg))
 	{
-		ptr = (int *) f->esp + i + 1;
-		check_validity((const void *) ptr);
-		arg[i] = *ptr;
+		exit(-1);
 	}
 }
 //---------------------------------
@@ -1,25 +1,45 @@
 #ifndef USERPROG_SYSCALL_H
 #define USERPROG_SYSCALL_H
+#include <hash.h>
 #include "threads/synch.h"
 
+struct thread;
+
+/* Shared by a parent and one of its children.  Each holds a
+   reference, so that either may exit first. */
 struct process_info {
 	bool wait; 
 	bool exit;
 	int status;
 	int pid;
 	int load;
+	int ref_cnt;				/* References held, 0 to 2. */
+	struct thread *parent;			/* Null once the parent exits. */
 	struct semaphore load_semaphore;
 	struct semaphore exit_semaphore;
-	struct list_elem elem;
+	struct hash_elem elem;			/* In parent's children. */
+	struct list_elem exit_elem;		/* In parent's exited_children. */
 };
 
+bool children_init (struct thread *);
 struct process_info* get_child_process (int pid);
 void remove_child_process (struct process_info *cp);
 struct process_info* add_child(int pid);
 void remove_child_proc(void);
+void release_child (struct process_info *cp);
 
 void process_close_file (int fd);
 
+void stdout_flush (void);
+
+bool inherit_files (struct list *files, int *fd);
+void adopt_files (struct list *files, int fd);
+void release_files (struct list *files);
+
 void syscall_init (void);
 
+struct intr_frame;
+void syscall_sysenter (struct intr_frame *);
+void sysenter_entry (void);
+
 #endif /* userprog/syscall.h */
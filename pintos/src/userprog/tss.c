@@ -1,7 +1,9 @@
 #include "userprog/tss.h"
+#include <cpu.h>
 #include <debug.h>
 #include <stddef.h>
 #include "userprog/gdt.h"
+#include "userprog/syscall.h"
 #include "threads/thread.h"
 #include "threads/palloc.h"
 #include "threads/vaddr.h"
@@ -75,6 +77,18 @@ struct tss
 /* Kernel TSS. */
 static struct tss *tss;
 
+/* Model-specific registers used by SYSENTER. */
+#define MSR_SYSENTER_CS  0x174          /* Kernel code segment. */
+#define MSR_SYSENTER_ESP 0x175          /* Kernel stack pointer. */
+#define MSR_SYSENTER_EIP 0x176          /* Kernel entry point. */
+
+/* Writes VALUE to model-specific register MSR. */
+static inline void
+wrmsr (uint32_t msr, uint64_t value)
+{
+  asm volatile ("wrmsr" : : "c" (msr), "A" (value));
+}
+
 /* Initializes the kernel TSS. */
 void
 tss_init (void) 
@@ -86,6 +100,20 @@ tss_init (void)
   tss->ss0 = SEL_KDSEG;
   tss->bitmap = 0xdfff;
   tss_update ();
+
+  /* Let user programs make system calls with SYSENTER, if the
+     CPU has it; lib/user/entry.c makes the same check.  SYSENTER
+     takes SS from the selector after CS and SYSEXIT takes the
+     user CS and SS from the two after that, which matches our
+     GDT.  The stack pointer it loads is the address of `esp0',
+     which sysenter_entry dereferences, so that we do not have to
+     rewrite the MSR on every thread switch. */
+  if (cpu_has_sysenter ())
+    {
+      wrmsr (MSR_SYSENTER_CS, SEL_KCSEG);
+      wrmsr (MSR_SYSENTER_ESP, (uint32_t) &tss->esp0);
+      wrmsr (MSR_SYSENTER_EIP, (uint32_t) sysenter_entry);
+    }
 }
 
 /* Returns the kernel TSS. */
@@ -0,0 +1,210 @@
+#include "userprog/uaccess.h"
+#include "threads/interrupt.h"
+#include "threads/vaddr.h"
+
+/* Access to user memory.
+
+   Rather than walking the page directory in software to check
+   each user pointer, these functions simply access user memory
+   and let the MMU do the checking.  Each instruction that
+   accesses user memory has an entry in a table of fixups, which
+   gives the address to resume at if it page faults.  On a page
+   fault in kernel mode at a user address, page_fault() in
+   userprog/exception.c calls uaccess_fixup(), which looks up
+   the faulting instruction.  If it is one of ours, execution
+   resumes at its fixup with EAX set to -1, so the function sees
+   the failure and reports it to its caller.  Any other kernel
+   page fault is a bug, and is treated as one.
+
+   The MMU does not stop the kernel from accessing kernel
+   memory, so these functions check that user addresses are
+   below PHYS_BASE themselves.
+
+   Other kernel code must not touch user memory directly, except
+   for memory it has just checked with user_readable() or
+   user_writable().  A process's memory is never unmapped while
+   it runs, so a successful check stays good until it exits. */
+
+/* Emits a fixup table entry that resumes execution at label
+   RESUME if the instruction at label INSN page faults. */
+#define FIXUP(INSN, RESUME)                                     \
+        ".pushsection .uaccess_fixups, \"a\"; "                  \
+        ".long " INSN ", " RESUME "; "                          \
+        ".popsection; "
+
+/* An entry in the fixup table. */
+struct fixup
+  {
+    uintptr_t insn;             /* Instruction that may fault. */
+    uintptr_t resume;           /* Where to resume if it does. */
+  };
+
+/* The fixup table, gathered from the FIXUP entries by the linker
+   script threads/kernel.lds.S. */
+extern const struct fixup _start_uaccess_fixups[];
+extern const struct fixup _end_uaccess_fixups[];
+
+/* If F is a page fault in one of the instructions in this file
+   that access user memory, arranges for it to resume at that
+   instruction's fixup with EAX set to -1 and returns true.
+   Otherwise, returns false without changing F. */
+bool
+uaccess_fixup (struct intr_frame *f)
+{
+  const struct fixup *x;
+
+  for (x = _start_uaccess_fixups; x < _end_uaccess_fixups; x++)
+    if (x->insn == (uintptr_t) f->eip)
+      {
+        f->eip = (void (*) (void)) x->resume;
+        f->eax = 0xffffffff;
+        return true;
+      }
+  return false;
+}
+
+/* Returns true if the SIZE bytes starting at UADDR all lie in
+   user virtual memory. */
+static inline bool
+is_user_range (const void *uaddr, size_t size)
+{
+  uintptr_t start = (uintptr_t) uaddr;
+  uintptr_t end = start + size;
+
+  return end >= start && end <= (uintptr_t) PHYS_BASE;
+}
+
+/* Copies SIZE bytes from SRC to DST, recovering from page faults
+   as described above.  Returns true if successful, false if an
+   access faulted. */
+static bool
+copy_bytes (void *dst, const void *src, size_t size)
+{
+  size_t words = size / sizeof (uint32_t);
+  int error;
+
+  asm volatile ("1: rep movsl; movl %[tail], %%ecx; "
+                "2: rep movsb; xorl %%eax, %%eax; 3: "
+                FIXUP ("1b", "3b") FIXUP ("2b", "3b")
+                : "=&a" (error), "+D" (dst), "+S" (src), "+c" (words)
+                : [tail] "r" (size % sizeof (uint32_t))
+                : "memory");
+  return error == 0;
+}
+
+/* Reads a byte at user virtual address USRC into *DST.  Returns
+   true if successful, false if USRC is not a valid user
+   address. */
+bool
+get_user (uint8_t *dst, const uint8_t *usrc)
+{
+  int result;
+
+  if (!is_user_vaddr (usrc))
+    return false;
+  asm volatile ("1: movzbl %1, %0; 2: " FIXUP ("1b", "2b")
+                : "=&a" (result) : "m" (*usrc));
+  if (result == -1)
+    return false;
+  *dst = result;
+  return true;
+}
+
+/* Writes BYTE to user virtual address UDST.  Returns true if
+   successful, false if UDST is not a valid, writable user
+   address. */
+bool
+put_user (uint8_t *udst, uint8_t byte)
+{
+  int error_code;
+
+  if (!is_user_vaddr (udst))
+    return false;
+  asm volatile ("xorl %0, %0; 1: movb %b2, %1; 2: " FIXUP ("1b", "2b")
+                : "=&a" (error_code), "=m" (*udst) : "q" (byte));
+  return error_code != -1;
+}
+
+/* Copies SIZE bytes from user address USRC to kernel address
+   DST.  Returns true if successful, false if any of the source
+   bytes is not valid user memory, in which case DST may have
+   been partly written. */
+bool
+copy_from_user (void *dst, const void *usrc, size_t size)
+{
+  return is_user_range (usrc, size) && copy_bytes (dst, usrc, size);
+}
+
+/* Copies SIZE bytes from kernel address SRC to user address
+   UDST.  Returns true if successful, false if any of the
+   destination bytes is not valid, writable user memory, in which
+   case UDST may have been partly written. */
+bool
+copy_to_user (void *udst, const void *src, size_t size)
+{
+  return is_user_range (udst, size) && copy_bytes (udst, src, size);
+}
+
+/* Copies the null-terminated string at user address USRC into
+   the SIZE bytes at DST.  Returns the length of the string if it
+   fits, or SIZE if there is no null terminator in its first
+   SIZE bytes.  Returns -1 if the string is not valid user
+   memory. */
+int
+strncpy_from_user (char *dst, const char *usrc, size_t size)
+{
+  size_t i;
+
+  for (i = 0; i < size; i++)
+    {
+      uint8_t c;
+
+      if (!get_user (&c, (const uint8_t *) usrc + i))
+        return -1;
+      dst[i] = c;
+      if (c == '\0')
+        return i;
+    }
+  return size;
+}
+
+/* Returns true if the SIZE bytes at UBUF are valid user memory,
+   touching one byte in each page to find out. */
+bool
+user_readable (const void *ubuf, size_t size)
+{
+  const uint8_t *p = ubuf;
+  const uint8_t *end = p + size;
+
+  if (!is_user_range (ubuf, size))
+    return false;
+  for (; p < end; p = (const uint8_t *) pg_round_down (p) + PGSIZE)
+    {
+      uint8_t byte;
+
+      if (!get_user (&byte, p))
+        return false;
+    }
+  return true;
+}
+
+/* Returns true if the SIZE bytes at UBUF are valid, writable
+   user memory, rewriting one byte in each page with its own
+   value to find out. */
+bool
+user_writable (void *ubuf, size_t size)
+{
+  uint8_t *p = ubuf;
+  uint8_t *end = p + size;
+
+  if (!is_user_range (ubuf, size))
+    return false;
+  for (; p < end; p = (uint8_t *) pg_round_down (p) + PGSIZE)
+    {
+      uint8_t byte;
+
+      if (!get_user (&byte, p) || !put_user (p, byte))
+        return false;
+    }
+  return true;
+}